@@ -0,0 +1,159 @@
+#include <cmath>
+#include <omp.h>
+
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+#include "env.h"
+#include "graph.h"
+#include "importer.h"
+#include "algorithms/bc.h"
+
+using namespace dcsr;
+using namespace std;
+namespace fs = std::filesystem;
+
+#define EXPOUT "[EXPOUT]"
+
+template<typename RE>
+size_t load_dataset(const fs::path& dataset, RawEdge32<void>* edge_buffer) {
+    size_t vertex_count = 0;
+    size_t i = 0;
+    ScanLargeFile<RE, 8*1024*1024>(dataset, [&](RE e) {
+        edge_buffer[i++] = RawEdge32<void>{e.from, e.to};
+        if(e.from >= vertex_count) {
+            vertex_count = e.from + 1;
+        }
+        if(e.to >= vertex_count) {
+            vertex_count = e.to + 1;
+        }
+    });
+    return vertex_count;
+}
+
+// Sum of dependencies of sources by sequential Brandes (BFS, then the stack in reverse), reference for the check
+template<typename GraphType>
+std::vector<double> reference_bc(const GraphType* g, std::span<const VID32> sources) {
+    size_t v_count = g->VertexCount();
+    std::vector<double> scores(v_count), sigma(v_count), delta(v_count);
+    std::vector<int64_t> depth(v_count, -1);
+    std::vector<VID32> order;
+    for(VID32 s: sources) {
+        order.assign(1, s);
+        depth[s] = 0;
+        sigma[s] = 1;
+        for(size_t head = 0; head < order.size(); head++) {
+            VID32 v = order[head];
+            g->IterateNeighborsOut(v, [&](VID32 w) {
+                if(depth[w] < 0) {
+                    depth[w] = depth[v] + 1;
+                    order.push_back(w);
+                }
+                if(depth[w] == depth[v] + 1) {
+                    sigma[w] += sigma[v];
+                }
+            });
+        }
+        for(size_t i = order.size(); i-- > 0; ) {
+            VID32 v = order[i];
+            g->IterateNeighborsOut(v, [&](VID32 w) {
+                if(depth[w] == depth[v] + 1) {
+                    delta[v] += sigma[v] / sigma[w] * (1 + delta[w]);
+                }
+            });
+            if(v != s) {
+                scores[v] += delta[v];
+            }
+        }
+        for(VID32 v: order) {
+            sigma[v] = 0;
+            delta[v] = 0;
+            depth[v] = -1;
+        }
+    }
+    return scores;
+}
+
+// Scores must match sequential Brandes on a few sources, and not depend on the tile narrowed by the memory budget
+int main(int argc, char** argv) {
+    cxxopts::Options options("bc", "Betweenness centrality on TGraph");
+    options.add_options()
+        ("h,help", "Print help")
+        ("f,input", "Dataset to use", cxxopts::value<string>())
+        ("b32", "Load 32 bit dataset. (Graph32 is always 32 bit, but you can load 64 bit dataset)")
+        ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
+        ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
+        ("s,sources", "Number of sampled sources, 0 for exact", cxxopts::value<size_t>()->default_value("256"))
+        ("c,checked", "Number of sources checked against sequential Brandes", cxxopts::value<size_t>()->default_value("8"))
+        ("m,memory", "Memory budget of the narrowed run in MB, 0 for a tile of 7 sources", cxxopts::value<size_t>()->default_value("0"))
+        ;
+
+    auto result = options.parse(argc, argv);
+    bool b32_dataset = result["b32"].as<bool>();
+    fs::path dataset = result["input"].as<string>();
+    size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
+    size_t edge_count = fs::file_size(dataset) / edge_size;
+
+    SimpleTimer timer;
+
+    auto edge_buffer = std::make_unique_for_overwrite<RawEdge32<void>[]>(edge_count);
+    size_t vertex_count = 0;
+    if(!b32_dataset) {
+        vertex_count = load_dataset<RawEdge64<void>>(dataset, edge_buffer.get());
+    } else {
+        vertex_count = load_dataset<RawEdge32<void>>(dataset, edge_buffer.get());
+    }
+    size_t thread_count = result.count("thread") ? result["thread"].as<size_t>() : GetLogicalCoreCount();
+    size_t batch_size = result["batch_size"].as<size_t>();
+    size_t source_count = result["sources"].as<size_t>();
+    size_t budget = result["memory"].as<size_t>() << 20;
+    if(budget == 0) {
+        budget = (sizeof(double) + sizeof(float) + sizeof(uint16_t)) * vertex_count * 7;
+    }
+    Config config = GenerateTGraphConfig(vertex_count, edge_count, thread_count);
+    fmt::println("Config:\n{}", config);
+    auto t_load = timer.Lap();
+
+    auto g = std::make_unique<TGraph32<void>>("./data/tmp_graph/", config);
+    for(size_t i = 0; i < edge_count; i+=batch_size) {
+        size_t len = std::min(batch_size, edge_count - i);
+        g->AddEdgeBatch(std::span<const RawEdge32<void>>(edge_buffer.get() + i, len));
+    }
+    g->Collect();
+    g->WaitSortingAndPrepareAnalysis();
+    auto t_ingest = timer.Lap();
+
+    auto full = bc(g.get(), source_count);
+    auto t_full = timer.Lap();
+    auto narrow = bc(g.get(), source_count, 27491095, budget);
+    auto t_narrow = timer.Lap();
+
+    std::vector<VID32> checked(std::min(result["checked"].as<size_t>(), vertex_count));
+    for(size_t i = 0; i < checked.size(); i++) {
+        checked[i] = i * vertex_count / checked.size();
+    }
+    auto partial = bc_sources(g.get(), std::span<const VID32>(checked));
+    auto reference = reference_bc(g.get(), std::span<const VID32>(checked));
+    g->FinishAlgorithm();
+
+    // Float sums against double, and the same sources with another order of float additions
+    size_t mismatch = 0;
+    float max_score = 0;
+    double sum = 0;
+    for(size_t v = 0; v < vertex_count; v++) {
+        mismatch += std::abs(full[v] - narrow[v]) > 1e-3f * std::max(1.0f, full[v]);
+        mismatch += std::abs(partial[v] - reference[v]) > 1e-3 * std::max(1.0, reference[v]);
+        max_score = std::max(max_score, full[v]);
+        sum += full[v];
+    }
+    fmt::println("Max score: {:.1f}, sum: {:.1f}, mismatch: {}", max_score, sum, mismatch);
+
+    fmt::println(EXPOUT "Dataset: {}", dataset.string());
+    fmt::println(EXPOUT "Vertex count: {}", vertex_count);
+    fmt::println(EXPOUT "Load: {:.3f}s", t_load);
+    fmt::println(EXPOUT "Ingest: {:.3f}s", t_ingest);
+    fmt::println(EXPOUT "BC: {:.3f}s", t_full);
+    fmt::println(EXPOUT "BC (budget {:.1f} MB): {:.3f}s", budget / 1048576.0, t_narrow);
+    return mismatch != 0;
+}
@@ -0,0 +1,135 @@
+#include <omp.h>
+
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+#include "env.h"
+#include "graph.h"
+#include "importer.h"
+#include "algorithms.h"
+
+using namespace dcsr;
+using namespace std;
+namespace fs = std::filesystem;
+
+#define EXPOUT "[EXPOUT]"
+
+template<typename RE>
+size_t load_dataset(const fs::path& dataset, RawEdge32<void>* edge_buffer) {
+    size_t vertex_count = 0;
+    size_t i = 0;
+    ScanLargeFile<RE, 8*1024*1024>(dataset, [&](RE e) {
+        edge_buffer[i++] = RawEdge32<void>{e.from, e.to};
+        if(e.from >= vertex_count) {
+            vertex_count = e.from + 1;
+        }
+        if(e.to >= vertex_count) {
+            vertex_count = e.to + 1;
+        }
+    });
+    return vertex_count;
+}
+
+// Depth of each vertex in a BFS parent tree, -1 for unreachable
+template<typename ParentType>
+std::vector<int64_t> tree_depths(const ParentType& parents, size_t vertex_count) {
+    std::vector<int64_t> depth(vertex_count, -2);
+    std::vector<size_t> chain;
+    for(size_t v = 0; v < vertex_count; v++) {
+        size_t u = v;
+        while(depth[u] == -2 && parents[u] >= 0 && size_t(parents[u]) != u) {
+            chain.push_back(u);
+            u = parents[u];
+        }
+        if(depth[u] == -2) {
+            depth[u] = parents[u] < 0 ? -1 : 0;
+        }
+        for(; !chain.empty(); chain.pop_back()) {
+            depth[chain.back()] = depth[u] < 0 ? -1 : depth[u] + 1;
+            u = chain.back();
+        }
+    }
+    return depth;
+}
+
+// BFS on the Ligra EdgeMap, parents are checked against the levels of the direction optimizing BFS of GAP
+int main(int argc, char** argv) {
+    cxxopts::Options options("bfs_ligra", "BFS on EdgeMap checked against GAP BFS");
+    options.add_options()
+        ("h,help", "Print help")
+        ("f,input", "Dataset to use", cxxopts::value<string>())
+        ("b32", "Load 32 bit dataset. (Graph32 is always 32 bit, but you can load 64 bit dataset)")
+        ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
+        ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
+        ("r,roots", "Number of BFS roots", cxxopts::value<size_t>()->default_value("8"))
+        ;
+
+    auto result = options.parse(argc, argv);
+    bool b32_dataset = result["b32"].as<bool>();
+    fs::path dataset = result["input"].as<string>();
+    size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
+    size_t edge_count = fs::file_size(dataset) / edge_size;
+
+    SimpleTimer timer;
+
+    auto edge_buffer = std::make_unique_for_overwrite<RawEdge32<void>[]>(edge_count);
+    size_t vertex_count = 0;
+    if(!b32_dataset) {
+        vertex_count = load_dataset<RawEdge64<void>>(dataset, edge_buffer.get());
+    } else {
+        vertex_count = load_dataset<RawEdge32<void>>(dataset, edge_buffer.get());
+    }
+    size_t thread_count = result.count("thread") ? result["thread"].as<size_t>() : GetLogicalCoreCount();
+    size_t batch_size = result["batch_size"].as<size_t>();
+    size_t roots = result["roots"].as<size_t>();
+    Config config = GenerateTGraphConfig(vertex_count, edge_count, thread_count);
+    fmt::println("Config:\n{}", config);
+    auto t_load = timer.Lap();
+
+    auto g = std::make_unique<TGraph32<void>>("./data/tmp_graph/", config);
+    for(size_t i = 0; i < edge_count; i+=batch_size) {
+        size_t len = std::min(batch_size, edge_count - i);
+        g->AddEdgeBatch(std::span<const RawEdge32<void>>(edge_buffer.get() + i, len));
+    }
+    g->Collect();
+    g->WaitSortingAndPrepareAnalysis();
+    auto t_ingest = timer.Lap();
+
+    double t_ligra = 0, t_gapbs = 0;
+    size_t bad = 0;
+    for(size_t i = 0; i < roots; i++) {
+        VID32 root = i * vertex_count / roots;
+        timer.Lap();
+        auto ligra = bfs_ligra(g.get(), root);
+        t_ligra += timer.Lap();
+        auto gapbs = bfs_gapbs(g.get(), root);
+        t_gapbs += timer.Lap();
+
+        // Same reached set, and each parent is an in-neighbor one level up
+        auto depth = tree_depths(gapbs, vertex_count);
+        size_t reached = 0, root_bad = 0;
+        #pragma omp parallel for reduction(+:reached, root_bad)
+        for(size_t v = 0; v < vertex_count; v++) {
+            int64_t p = ligra[v];
+            reached += p >= 0;
+            if((p >= 0) != (depth[v] >= 0)) {
+                root_bad++;
+            } else if(p >= 0 && v != root) {
+                root_bad += depth[p] != depth[v] - 1 || !g->HasEdge(p, v);
+            }
+        }
+        root_bad += ligra[root] != root;
+        fmt::println("Root {}: {} reached, bad: {}", root, reached, root_bad);
+        bad += root_bad;
+    }
+    g->FinishAlgorithm();
+
+    fmt::println(EXPOUT "Dataset: {}", dataset.string());
+    fmt::println(EXPOUT "Vertex count: {}", vertex_count);
+    fmt::println(EXPOUT "Load: {:.3f}s", t_load);
+    fmt::println(EXPOUT "Ingest: {:.3f}s", t_ingest);
+    fmt::println(EXPOUT "BFS (ligra): {:.3f}s", t_ligra);
+    fmt::println(EXPOUT "BFS (gapbs): {:.3f}s", t_gapbs);
+    return bad != 0;
+}
@@ -0,0 +1,116 @@
+#include <numeric>
+#include <omp.h>
+
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+#include "env.h"
+#include "graph.h"
+#include "importer.h"
+#include "algorithms/community.h"
+
+using namespace dcsr;
+using namespace std;
+namespace fs = std::filesystem;
+
+#define EXPOUT "[EXPOUT]"
+
+template<typename RE>
+size_t load_dataset(const fs::path& dataset, RawEdge32<void>* edge_buffer) {
+    size_t vertex_count = 0;
+    size_t i = 0;
+    ScanLargeFile<RE, 8*1024*1024>(dataset, [&](RE e) {
+        edge_buffer[i++] = RawEdge32<void>{e.from, e.to};
+        if(e.from >= vertex_count) {
+            vertex_count = e.from + 1;
+        }
+        if(e.to >= vertex_count) {
+            vertex_count = e.to + 1;
+        }
+    });
+    return vertex_count;
+}
+
+// Number of distinct communities, 0 if a community is not a vertex ID
+size_t community_count(const VID32* community, size_t vertex_count) {
+    std::vector<uint8_t> used(vertex_count);
+    size_t count = 0;
+    for(size_t v = 0; v < vertex_count; v++) {
+        if(community[v] >= vertex_count) {
+            return 0;
+        }
+        count += !used[community[v]];
+        used[community[v]] = 1;
+    }
+    return count;
+}
+
+// Label propagation and Louvain local moving on UGraph, Louvain must not lose modularity to singletons
+int main(int argc, char** argv) {
+    cxxopts::Options options("community", "Community detection on UGraph");
+    options.add_options()
+        ("h,help", "Print help")
+        ("f,input", "Dataset to use", cxxopts::value<string>())
+        ("b32", "Load 32 bit dataset. (Graph32 is always 32 bit, but you can load 64 bit dataset)")
+        ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
+        ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
+        ("i,iterations", "Maximum passes of each algorithm", cxxopts::value<size_t>()->default_value("20"))
+        ;
+
+    auto result = options.parse(argc, argv);
+    bool b32_dataset = result["b32"].as<bool>();
+    fs::path dataset = result["input"].as<string>();
+    size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
+    size_t edge_count = fs::file_size(dataset) / edge_size;
+
+    SimpleTimer timer;
+
+    auto edge_buffer = std::make_unique_for_overwrite<RawEdge32<void>[]>(edge_count);
+    size_t vertex_count = 0;
+    if(!b32_dataset) {
+        vertex_count = load_dataset<RawEdge64<void>>(dataset, edge_buffer.get());
+    } else {
+        vertex_count = load_dataset<RawEdge32<void>>(dataset, edge_buffer.get());
+    }
+    size_t thread_count = result.count("thread") ? result["thread"].as<size_t>() : GetLogicalCoreCount();
+    size_t batch_size = result["batch_size"].as<size_t>();
+    size_t iterations = result["iterations"].as<size_t>();
+    Config config = GenerateUGraphConfig(vertex_count, edge_count, thread_count);
+    fmt::println("Config:\n{}", config);
+    auto t_load = timer.Lap();
+
+    auto g = std::make_unique<UGraph32<void>>("./data/tmp_graph/", config);
+    for(size_t i = 0; i < edge_count; i+=batch_size) {
+        size_t len = std::min(batch_size, edge_count - i);
+        g->AddEdgeBatch(std::span<const RawEdge32<void>>(edge_buffer.get() + i, len));
+    }
+    g->Collect();
+    g->WaitSortingAndPrepareAnalysis();
+    auto t_ingest = timer.Lap();
+
+    auto labels = label_propagation(g.get(), iterations);
+    auto t_lp = timer.Lap();
+    auto community = louvain_local_moving(g.get(), iterations);
+    auto t_louvain = timer.Lap();
+
+    auto singletons = std::make_unique<VID32[]>(vertex_count);
+    std::iota(singletons.get(), singletons.get() + vertex_count, VID32(0));
+    double q_singletons = modularity(g.get(), singletons.get());
+    double q_lp = modularity(g.get(), labels.get());
+    double q_louvain = modularity(g.get(), community.get());
+    g->FinishAlgorithm();
+
+    size_t lp_count = community_count(labels.get(), vertex_count);
+    size_t louvain_count = community_count(community.get(), vertex_count);
+    fmt::println("Label propagation: {} communities, modularity {:.4f}", lp_count, q_lp);
+    fmt::println("Louvain: {} communities, modularity {:.4f} (singletons {:.4f})", louvain_count, q_louvain, q_singletons);
+
+    fmt::println(EXPOUT "Dataset: {}", dataset.string());
+    fmt::println(EXPOUT "Vertex count: {}", vertex_count);
+    fmt::println(EXPOUT "Load: {:.3f}s", t_load);
+    fmt::println(EXPOUT "Ingest: {:.3f}s", t_ingest);
+    fmt::println(EXPOUT "Label propagation: {:.3f}s", t_lp);
+    fmt::println(EXPOUT "Louvain: {:.3f}s", t_louvain);
+    return lp_count == 0 || louvain_count == 0 || q_louvain < q_singletons;
+}
@@ -0,0 +1,164 @@
+#include <numeric>
+#include <omp.h>
+
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+#include "env.h"
+#include "graph.h"
+#include "importer.h"
+#include "algorithms/kcore.h"
+
+using namespace dcsr;
+using namespace std;
+namespace fs = std::filesystem;
+
+#define EXPOUT "[EXPOUT]"
+
+template<typename RE>
+size_t load_dataset(const fs::path& dataset, RawEdge32<void>* edge_buffer) {
+    size_t vertex_count = 0;
+    size_t i = 0;
+    ScanLargeFile<RE, 8*1024*1024>(dataset, [&](RE e) {
+        edge_buffer[i++] = RawEdge32<void>{e.from, e.to};
+        if(e.from >= vertex_count) {
+            vertex_count = e.from + 1;
+        }
+        if(e.to >= vertex_count) {
+            vertex_count = e.to + 1;
+        }
+    });
+    return vertex_count;
+}
+
+// Core numbers by sequential Batagelj-Zaversnik peeling of the edge list, undirected multigraph like kcore
+std::vector<uint32_t> reference_kcore(const RawEdge32<void>* edges, size_t edge_count, size_t vertex_count) {
+    std::vector<size_t> offset(vertex_count + 1, 0);
+    for(size_t i = 0; i < edge_count; i++) {
+        offset[edges[i].from + 1]++;
+        offset[edges[i].to + 1]++;
+    }
+    std::partial_sum(offset.begin(), offset.end(), offset.begin());
+    std::vector<uint32_t> adj(offset[vertex_count]);
+    std::vector<size_t> cursor(offset.begin(), offset.end() - 1);
+    for(size_t i = 0; i < edge_count; i++) {
+        adj[cursor[edges[i].from]++] = edges[i].to;
+        adj[cursor[edges[i].to]++] = edges[i].from;
+    }
+
+    // Vertices sorted by degree (vert), pos is the index in vert, bin the first index of each degree
+    std::vector<uint32_t> degree(vertex_count);
+    uint32_t max_degree = 0;
+    for(size_t v = 0; v < vertex_count; v++) {
+        degree[v] = offset[v + 1] - offset[v];
+        max_degree = std::max(max_degree, degree[v]);
+    }
+    std::vector<size_t> bin(max_degree + 2, 0);
+    for(size_t v = 0; v < vertex_count; v++) {
+        bin[degree[v] + 1]++;
+    }
+    std::partial_sum(bin.begin(), bin.end(), bin.begin());
+    std::vector<size_t> pos(vertex_count);
+    std::vector<uint32_t> vert(vertex_count);
+    std::vector<size_t> next(bin.begin(), bin.end() - 1);
+    for(size_t v = 0; v < vertex_count; v++) {
+        pos[v] = next[degree[v]]++;
+        vert[pos[v]] = v;
+    }
+    for(size_t i = 0; i < vertex_count; i++) {
+        uint32_t v = vert[i];
+        for(size_t j = offset[v]; j < offset[v + 1]; j++) {
+            uint32_t u = adj[j];
+            if(degree[u] > degree[v]) {
+                // Swap u with the first vertex of its degree, then move the bin boundary past it
+                uint32_t du = degree[u];
+                size_t pw = bin[du];
+                uint32_t w = vert[pw];
+                std::swap(vert[pos[u]], vert[pw]);
+                std::swap(pos[u], pos[w]);
+                bin[du]++;
+                degree[u]--;
+            }
+        }
+    }
+    return degree;
+}
+
+// Core numbers of the same edges ingested as UGraph and as TGraph must equal a sequential peeling
+int main(int argc, char** argv) {
+    cxxopts::Options options("kcore", "k-core decomposition on UGraph and TGraph");
+    options.add_options()
+        ("h,help", "Print help")
+        ("f,input", "Dataset to use", cxxopts::value<string>())
+        ("b32", "Load 32 bit dataset. (Graph32 is always 32 bit, but you can load 64 bit dataset)")
+        ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
+        ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
+        ;
+
+    auto result = options.parse(argc, argv);
+    bool b32_dataset = result["b32"].as<bool>();
+    fs::path dataset = result["input"].as<string>();
+    size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
+    size_t edge_count = fs::file_size(dataset) / edge_size;
+
+    SimpleTimer timer;
+
+    auto edge_buffer = std::make_unique_for_overwrite<RawEdge32<void>[]>(edge_count);
+    size_t vertex_count = 0;
+    if(!b32_dataset) {
+        vertex_count = load_dataset<RawEdge64<void>>(dataset, edge_buffer.get());
+    } else {
+        vertex_count = load_dataset<RawEdge32<void>>(dataset, edge_buffer.get());
+    }
+    size_t thread_count = result.count("thread") ? result["thread"].as<size_t>() : GetLogicalCoreCount();
+    size_t batch_size = result["batch_size"].as<size_t>();
+    auto t_load = timer.Lap();
+
+    std::unique_ptr<uint32_t[]> ucore, tcore;
+    double t_ucore = 0, t_tcore = 0;
+    {
+        Config config = GenerateUGraphConfig(vertex_count, edge_count, thread_count);
+        auto g = std::make_unique<UGraph32<void>>("./data/tmp_graph/", config);
+        for(size_t i = 0; i < edge_count; i+=batch_size) {
+            size_t len = std::min(batch_size, edge_count - i);
+            g->AddEdgeBatch(std::span<const RawEdge32<void>>(edge_buffer.get() + i, len));
+        }
+        g->Collect();
+        g->WaitSortingAndPrepareAnalysis();
+        timer.Lap();
+        ucore = kcore(g.get());
+        t_ucore = timer.Lap();
+        g->FinishAlgorithm();
+    }
+    {
+        Config config = GenerateTGraphConfig(vertex_count, edge_count, thread_count);
+        auto g = std::make_unique<TGraph32<void>>("./data/tmp_graph/", config);
+        for(size_t i = 0; i < edge_count; i+=batch_size) {
+            size_t len = std::min(batch_size, edge_count - i);
+            g->AddEdgeBatch(std::span<const RawEdge32<void>>(edge_buffer.get() + i, len));
+        }
+        g->Collect();
+        g->WaitSortingAndPrepareAnalysis();
+        timer.Lap();
+        tcore = kcore(g.get());
+        t_tcore = timer.Lap();
+        g->FinishAlgorithm();
+    }
+
+    auto reference = reference_kcore(edge_buffer.get(), edge_count, vertex_count);
+    size_t mismatch = 0;
+    uint32_t max_core = 0;
+    for(size_t v = 0; v < vertex_count; v++) {
+        mismatch += ucore[v] != reference[v] || tcore[v] != reference[v];
+        max_core = std::max(max_core, ucore[v]);
+    }
+    fmt::println("Max core: {}, mismatch: {}", max_core, mismatch);
+
+    fmt::println(EXPOUT "Dataset: {}", dataset.string());
+    fmt::println(EXPOUT "Vertex count: {}", vertex_count);
+    fmt::println(EXPOUT "Load: {:.3f}s", t_load);
+    fmt::println(EXPOUT "KCore (UGraph): {:.3f}s", t_ucore);
+    fmt::println(EXPOUT "KCore (TGraph): {:.3f}s", t_tcore);
+    return mismatch != 0;
+}
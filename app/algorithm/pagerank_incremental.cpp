@@ -0,0 +1,151 @@
+#include <cmath>
+#include <omp.h>
+
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+#include "env.h"
+#include "graph.h"
+#include "importer.h"
+#include "algorithms/pr_incremental.h"
+#include "algorithms/gapbs/pr.h"
+
+using namespace dcsr;
+using namespace std;
+namespace fs = std::filesystem;
+
+#define EXPOUT "[EXPOUT]"
+
+template<typename RE>
+size_t load_dataset(const fs::path& dataset, RawEdge32<void>* edge_buffer) {
+    size_t vertex_count = 0;
+    size_t i = 0;
+    ScanLargeFile<RE, 8*1024*1024>(dataset, [&](RE e) {
+        edge_buffer[i++] = RawEdge32<void>{e.from, e.to};
+        if(e.from >= vertex_count) {
+            vertex_count = e.from + 1;
+        }
+        if(e.to >= vertex_count) {
+            vertex_count = e.to + 1;
+        }
+    });
+    return vertex_count;
+}
+
+// PageRank from scratch in double by pull iterations (same formula as IncrementalPageRank), reference for the check
+template<typename GraphType>
+std::vector<double> reference_pagerank(const GraphType* g, size_t max_iters = 1000, double tolerance = 1e-12) {
+    using VID = typename GraphType::VertexType;
+    size_t v_count = g->VertexCount();
+    double base = (1.0 - IncrementalPageRank<GraphType>::DAMP) / v_count;
+    std::vector<double> scores(v_count, 1.0 / v_count), contrib(v_count), next(v_count);
+    for(size_t iter = 0; iter < max_iters; iter++) {
+        #pragma omp parallel for
+        for(size_t v = 0; v < v_count; v++) {
+            size_t degree = g->GetDegreeOut(v);
+            contrib[v] = degree == 0 ? 0 : scores[v] / degree;
+        }
+        double change = 0;
+        #pragma omp parallel for schedule(dynamic, 1024) reduction(+:change)
+        for(size_t v = 0; v < v_count; v++) {
+            double incoming = 0;
+            g->IterateNeighborsIn(v, [&](VID u) {
+                incoming += contrib[u];
+            });
+            next[v] = base + IncrementalPageRank<GraphType>::DAMP * incoming;
+            change += std::abs(next[v] - scores[v]);
+        }
+        scores.swap(next);
+        if(change < tolerance) {
+            break;
+        }
+    }
+    return scores;
+}
+
+// Ingest the dataset in rounds, keep PageRank up to date after each and compare with a full computation
+int main(int argc, char** argv) {
+    cxxopts::Options options("pagerank_incremental", "Incremental PageRank over ingested batches");
+    options.add_options()
+        ("h,help", "Print help")
+        ("f,input", "Dataset to use", cxxopts::value<string>())
+        ("b32", "Load 32 bit dataset. (Graph32 is always 32 bit, but you can load 64 bit dataset)")
+        ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
+        ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
+        ("r,rounds", "Number of ingest rounds, PageRank is updated after each", cxxopts::value<size_t>()->default_value("4"))
+        ("e,epsilon", "Residual threshold relative to (1 - d) / n", cxxopts::value<double>()->default_value("1e-4"))
+        ;
+
+    auto result = options.parse(argc, argv);
+    bool b32_dataset = result["b32"].as<bool>();
+    fs::path dataset = result["input"].as<string>();
+    size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
+    size_t edge_count = fs::file_size(dataset) / edge_size;
+
+    SimpleTimer timer;
+
+    auto edge_buffer = std::make_unique_for_overwrite<RawEdge32<void>[]>(edge_count);
+    size_t vertex_count = 0;
+    if(!b32_dataset) {
+        vertex_count = load_dataset<RawEdge64<void>>(dataset, edge_buffer.get());
+    } else {
+        vertex_count = load_dataset<RawEdge32<void>>(dataset, edge_buffer.get());
+    }
+
+    size_t thread_count = result.count("thread") ? result["thread"].as<size_t>() : GetLogicalCoreCount();
+    Config config = GenerateTGraphConfig(vertex_count, edge_count, thread_count);
+    config.track_touched = true;
+    fmt::println("Config:\n{}", config);
+    auto t_load = timer.Lap();
+
+    auto g = std::make_unique<TGraph32<void>>("./data/tmp_graph/", config);
+    std::unique_ptr<IncrementalPageRank<TGraph32<void>>> ipr;
+    size_t rounds = result["rounds"].as<size_t>();
+    size_t batch_size = result["batch_size"].as<size_t>();
+    double epsilon = result["epsilon"].as<double>();
+    double t_update = 0, t_full = 0, max_l1 = 0;
+    size_t done = 0;
+    for(size_t r = 0; r < rounds; r++) {
+        size_t upto = (r + 1 == rounds) ? edge_count : edge_count / rounds * (r + 1);
+        for(size_t i = done; i < upto; i+=batch_size) {
+            size_t len = std::min(batch_size, upto - i);
+            g->AddEdgeBatch(std::span<const RawEdge32<void>>(edge_buffer.get() + i, len));
+        }
+        done = upto;
+        g->WaitSortingAndPrepareAnalysis();
+        timer.Lap();
+
+        size_t push_rounds = 0;
+        if(!ipr) {
+            ipr = std::make_unique<IncrementalPageRank<TGraph32<void>>>(g.get(), epsilon);
+            push_rounds = ipr->Recompute();
+        } else {
+            push_rounds = ipr->Update();
+        }
+        auto t = timer.Lap();
+        t_update += t;
+
+        std::unique_ptr<ScoreT[]> full(PageRankPullGS(*g, 100, 1e-6));
+        t_full += timer.Lap();
+        auto reference = reference_pagerank(g.get());
+        double l1 = 0;
+        #pragma omp parallel for reduction(+:l1)
+        for(size_t v = 0; v < vertex_count; v++) {
+            l1 += std::abs(ipr->Scores()[v] - reference[v]);
+        }
+        timer.Lap();
+        max_l1 = std::max(max_l1, l1);
+        fmt::println("Round {}: {} edges, {} push rounds, {:.3f}s, L1 to PageRank from scratch: {:.2e}", r, done, push_rounds, t, l1);
+        g->FinishAlgorithm();
+    }
+
+    fmt::println(EXPOUT "Dataset: {}", dataset.string());
+    fmt::println(EXPOUT "Vertex count: {}", vertex_count);
+    fmt::println(EXPOUT "Load: {:.3f}s", t_load);
+    fmt::println(EXPOUT "PR (incremental): {:.3f}s", t_update);
+    fmt::println(EXPOUT "PR (full, pull GS): {:.3f}s", t_full);
+    fmt::println(EXPOUT "Max L1: {:.2e}", max_l1);
+    // Residuals left are below epsilon * base each, so L1 error is about epsilon
+    return max_l1 > 10 * epsilon;
+}
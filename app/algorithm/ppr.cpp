@@ -0,0 +1,166 @@
+#include <cmath>
+#include <random>
+#include <omp.h>
+
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+#include "env.h"
+#include "graph.h"
+#include "importer.h"
+#include "algorithms/ppr.h"
+
+using namespace dcsr;
+using namespace std;
+namespace fs = std::filesystem;
+
+#define EXPOUT "[EXPOUT]"
+
+template<typename RE>
+size_t load_dataset(const fs::path& dataset, RawEdge32<void>* edge_buffer) {
+    size_t vertex_count = 0;
+    size_t i = 0;
+    ScanLargeFile<RE, 8*1024*1024>(dataset, [&](RE e) {
+        edge_buffer[i++] = RawEdge32<void>{e.from, e.to};
+        if(e.from >= vertex_count) {
+            vertex_count = e.from + 1;
+        }
+        if(e.to >= vertex_count) {
+            vertex_count = e.to + 1;
+        }
+    });
+    return vertex_count;
+}
+
+// PPR of source by pull iterations over all vertices (dangling vertices return to source), reference for the check
+template<typename GraphType>
+std::vector<double> reference_ppr(const GraphType* g, typename GraphType::VertexType source, double alpha, size_t iters = 200) {
+    using VID = typename GraphType::VertexType;
+    size_t v_count = g->VertexCount();
+    std::vector<double> scores(v_count), contrib(v_count), next(v_count);
+    scores[source] = 1;
+    for(size_t iter = 0; iter < iters; iter++) {
+        double dangling = 0;
+        #pragma omp parallel for reduction(+:dangling)
+        for(size_t v = 0; v < v_count; v++) {
+            size_t degree = g->GetDegreeOut(v);
+            contrib[v] = degree == 0 ? 0 : scores[v] / degree;
+            dangling += degree == 0 ? scores[v] : 0;
+        }
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for(size_t v = 0; v < v_count; v++) {
+            double incoming = 0;
+            g->IterateNeighborsIn(v, [&](VID u) {
+                incoming += contrib[u];
+            });
+            next[v] = (1 - alpha) * incoming;
+        }
+        next[source] += alpha + (1 - alpha) * dangling;
+        scores.swap(next);
+    }
+    return scores;
+}
+
+// Forward push PPR queries from random sources in parallel, a few checked against power iteration
+int main(int argc, char** argv) {
+    cxxopts::Options options("ppr", "Personalized PageRank queries on TGraph");
+    options.add_options()
+        ("h,help", "Print help")
+        ("f,input", "Dataset to use", cxxopts::value<string>())
+        ("b32", "Load 32 bit dataset. (Graph32 is always 32 bit, but you can load 64 bit dataset)")
+        ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
+        ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
+        ("q,queries", "Number of queries", cxxopts::value<size_t>()->default_value("1024"))
+        ("c,checked", "Number of queries checked against power iteration", cxxopts::value<size_t>()->default_value("4"))
+        ("k,top", "Top k vertices returned by each query", cxxopts::value<size_t>()->default_value("10"))
+        ("a,alpha", "Teleport probability", cxxopts::value<double>()->default_value("0.15"))
+        ("e,epsilon", "Residual threshold per out edge", cxxopts::value<double>()->default_value("1e-6"))
+        ;
+
+    auto result = options.parse(argc, argv);
+    bool b32_dataset = result["b32"].as<bool>();
+    fs::path dataset = result["input"].as<string>();
+    size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
+    size_t edge_count = fs::file_size(dataset) / edge_size;
+
+    SimpleTimer timer;
+
+    auto edge_buffer = std::make_unique_for_overwrite<RawEdge32<void>[]>(edge_count);
+    size_t vertex_count = 0;
+    if(!b32_dataset) {
+        vertex_count = load_dataset<RawEdge64<void>>(dataset, edge_buffer.get());
+    } else {
+        vertex_count = load_dataset<RawEdge32<void>>(dataset, edge_buffer.get());
+    }
+    size_t thread_count = result.count("thread") ? result["thread"].as<size_t>() : GetLogicalCoreCount();
+    size_t batch_size = result["batch_size"].as<size_t>();
+    size_t query_count = result["queries"].as<size_t>();
+    size_t checked = std::min(result["checked"].as<size_t>(), query_count);
+    size_t k = result["top"].as<size_t>();
+    double alpha = result["alpha"].as<double>();
+    double epsilon = result["epsilon"].as<double>();
+    Config config = GenerateTGraphConfig(vertex_count, edge_count, thread_count);
+    fmt::println("Config:\n{}", config);
+    auto t_load = timer.Lap();
+
+    auto g = std::make_unique<TGraph32<void>>("./data/tmp_graph/", config);
+    for(size_t i = 0; i < edge_count; i+=batch_size) {
+        size_t len = std::min(batch_size, edge_count - i);
+        g->AddEdgeBatch(std::span<const RawEdge32<void>>(edge_buffer.get() + i, len));
+    }
+    g->Collect();
+    g->WaitSortingAndPrepareAnalysis();
+    auto t_ingest = timer.Lap();
+
+    std::vector<VID32> sources(query_count);
+    std::mt19937_64 rng(27491095);
+    for(auto& s: sources) {
+        s = rng() % vertex_count;
+    }
+
+    // One arena per thread, reused across its queries
+    std::vector<std::vector<std::pair<VID32, double>>> top(query_count);
+    size_t touched = 0;
+    #pragma omp parallel reduction(+:touched)
+    {
+        PPRArena<VID32> arena;
+        #pragma omp for schedule(dynamic, 1)
+        for(size_t i = 0; i < query_count; i++) {
+            top[i] = ppr_top_k(g.get(), sources[i], k, arena, alpha, epsilon);
+            touched += arena.TouchedCount();
+        }
+    }
+    auto t_query = timer.Lap();
+
+    // Forward push underestimates, by the residual mass left (at most epsilon per out edge)
+    size_t bad = 0;
+    double max_l1 = 0;
+    PPRArena<VID32> arena;
+    for(size_t i = 0; i < checked; i++) {
+        ppr_forward_push(g.get(), sources[i], arena, alpha, epsilon);
+        auto reference = reference_ppr(g.get(), sources[i], alpha);
+        double l1 = 0;
+        for(double score: reference) {
+            l1 += score;
+        }
+        arena.ForEachEstimate([&](VID32 v, double score) {
+            bad += score > reference[v] + 1e-9;
+            l1 -= score;
+        });
+        max_l1 = std::max(max_l1, l1);
+        bad += l1 > epsilon * edge_count;
+        for(auto [v, score]: top[i]) {
+            bad += std::abs(score - reference[v]) > l1 + 1e-9;
+        }
+    }
+    g->FinishAlgorithm();
+    fmt::println("Average touched: {:.1f}, checked {} queries, max L1: {:.2e}, bad: {}", double(touched) / query_count, checked, max_l1, bad);
+
+    fmt::println(EXPOUT "Dataset: {}", dataset.string());
+    fmt::println(EXPOUT "Vertex count: {}", vertex_count);
+    fmt::println(EXPOUT "Load: {:.3f}s", t_load);
+    fmt::println(EXPOUT "Ingest: {:.3f}s", t_ingest);
+    fmt::println(EXPOUT "PPR ({} queries): {:.3f}s", query_count, t_query);
+    return bad != 0;
+}
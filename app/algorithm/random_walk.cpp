@@ -0,0 +1,115 @@
+#include <omp.h>
+
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+#include "env.h"
+#include "graph.h"
+#include "importer.h"
+#include "algorithms/random_walk.h"
+
+using namespace dcsr;
+using namespace std;
+namespace fs = std::filesystem;
+
+#define EXPOUT "[EXPOUT]"
+
+template<typename RE>
+size_t load_dataset(const fs::path& dataset, RawEdge32<void>* edge_buffer) {
+    size_t vertex_count = 0;
+    size_t i = 0;
+    ScanLargeFile<RE, 8*1024*1024>(dataset, [&](RE e) {
+        edge_buffer[i++] = RawEdge32<void>{e.from, e.to};
+        if(e.from >= vertex_count) {
+            vertex_count = e.from + 1;
+        }
+        if(e.to >= vertex_count) {
+            vertex_count = e.to + 1;
+        }
+    });
+    return vertex_count;
+}
+
+// DeepWalk or node2vec walks on TGraph, every step must be an edge and walks end only at vertices without out edges
+int main(int argc, char** argv) {
+    cxxopts::Options options("random_walk", "Random walks on TGraph");
+    options.add_options()
+        ("h,help", "Print help")
+        ("f,input", "Dataset to use", cxxopts::value<string>())
+        ("b32", "Load 32 bit dataset. (Graph32 is always 32 bit, but you can load 64 bit dataset)")
+        ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
+        ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
+        ("l,length", "Vertices per walk", cxxopts::value<size_t>()->default_value("80"))
+        ("w,walks", "Walks per vertex", cxxopts::value<size_t>()->default_value("10"))
+        ("p", "node2vec return parameter", cxxopts::value<double>()->default_value("1"))
+        ("q", "node2vec in-out parameter", cxxopts::value<double>()->default_value("1"))
+        ;
+
+    auto result = options.parse(argc, argv);
+    bool b32_dataset = result["b32"].as<bool>();
+    fs::path dataset = result["input"].as<string>();
+    size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
+    size_t edge_count = fs::file_size(dataset) / edge_size;
+
+    SimpleTimer timer;
+
+    auto edge_buffer = std::make_unique_for_overwrite<RawEdge32<void>[]>(edge_count);
+    size_t vertex_count = 0;
+    if(!b32_dataset) {
+        vertex_count = load_dataset<RawEdge64<void>>(dataset, edge_buffer.get());
+    } else {
+        vertex_count = load_dataset<RawEdge32<void>>(dataset, edge_buffer.get());
+    }
+    size_t thread_count = result.count("thread") ? result["thread"].as<size_t>() : GetLogicalCoreCount();
+    size_t batch_size = result["batch_size"].as<size_t>();
+    RandomWalkConfig walk_config;
+    walk_config.walk_length = result["length"].as<size_t>();
+    walk_config.walks_per_vertex = result["walks"].as<size_t>();
+    walk_config.p = result["p"].as<double>();
+    walk_config.q = result["q"].as<double>();
+    Config config = GenerateTGraphConfig(vertex_count, edge_count, thread_count);
+    fmt::println("Config:\n{}", config);
+    auto t_load = timer.Lap();
+
+    auto g = std::make_unique<TGraph32<void>>("./data/tmp_graph/", config);
+    for(size_t i = 0; i < edge_count; i+=batch_size) {
+        size_t len = std::min(batch_size, edge_count - i);
+        g->AddEdgeBatch(std::span<const RawEdge32<void>>(edge_buffer.get() + i, len));
+    }
+    g->Collect();
+    g->WaitSortingAndPrepareAnalysis();
+    auto t_ingest = timer.Lap();
+
+    auto walks = random_walk(g.get(), walk_config);
+    auto t_walk = timer.Lap();
+
+    constexpr VID32 END = RandomWalkEnd<VID32>;
+    size_t length = walk_config.walk_length;
+    size_t walk_count = vertex_count * walk_config.walks_per_vertex;
+    size_t bad = 0, steps = 0, returns = 0;
+    #pragma omp parallel for reduction(+:bad, steps, returns) schedule(dynamic, 1024)
+    for(size_t w = 0; w < walk_count; w++) {
+        const VID32* walk = walks.get() + w * length;
+        bad += walk[0] != w % vertex_count;
+        for(size_t i = 1; i < length; i++) {
+            if(walk[i] == END) {
+                // Only a vertex without out edges ends a walk, the rest is padding
+                bad += walk[i - 1] == END ? 0 : g->GetDegreeOut(walk[i - 1]) != 0;
+                continue;
+            }
+            bad += walk[i - 1] == END || !g->HasEdge(walk[i - 1], walk[i]);
+            returns += i >= 2 && walk[i] == walk[i - 2];
+            steps++;
+        }
+    }
+    g->FinishAlgorithm();
+    fmt::println("Walks: {}, steps: {}, returns: {:.4f}, bad: {}", walk_count, steps, double(returns) / std::max<size_t>(steps, 1), bad);
+
+    fmt::println(EXPOUT "Dataset: {}", dataset.string());
+    fmt::println(EXPOUT "Vertex count: {}", vertex_count);
+    fmt::println(EXPOUT "Load: {:.3f}s", t_load);
+    fmt::println(EXPOUT "Ingest: {:.3f}s", t_ingest);
+    fmt::println(EXPOUT "Random walk: {:.3f}s", t_walk);
+    return bad != 0;
+}
@@ -0,0 +1,126 @@
+#include <omp.h>
+
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+#include "env.h"
+#include "graph.h"
+#include "importer.h"
+#include "relabel.h"
+#include "algorithms.h"
+
+using namespace dcsr;
+using namespace std;
+namespace fs = std::filesystem;
+
+#define EXPOUT "[EXPOUT]"
+
+template<typename RE>
+size_t load_dataset(const fs::path& dataset, RawEdge32<void>* edge_buffer) {
+    size_t vertex_count = 0;
+    size_t i = 0;
+    ScanLargeFile<RE, 8*1024*1024>(dataset, [&](RE e) {
+        edge_buffer[i++] = RawEdge32<void>{e.from, e.to};
+        if(e.from >= vertex_count) {
+            vertex_count = e.from + 1;
+        }
+        if(e.to >= vertex_count) {
+            vertex_count = e.to + 1;
+        }
+    });
+    return vertex_count;
+}
+
+// Ingest the dataset in rounds, count triangles incrementally after each and compare with a full count
+int main(int argc, char** argv) {
+    cxxopts::Options options("tc_incremental", "Incremental triangle counting over ingested batches");
+    options.add_options()
+        ("h,help", "Print help")
+        ("f,input", "Dataset to use", cxxopts::value<string>())
+        ("b32", "Load 32 bit dataset. (Graph32 is always 32 bit, but you can load 64 bit dataset)")
+        ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
+        ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
+        ("r,rounds", "Number of ingest rounds, triangles are counted after each", cxxopts::value<size_t>()->default_value("4"))
+        ("relabel", "Relabel vertices at ingest: degree, rcm or gorder", cxxopts::value<string>())
+        ;
+
+    auto result = options.parse(argc, argv);
+    bool b32_dataset = result["b32"].as<bool>();
+    fs::path dataset = result["input"].as<string>();
+    size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
+    size_t edge_count = fs::file_size(dataset) / edge_size;
+
+    SimpleTimer timer;
+
+    auto edge_buffer = std::make_unique_for_overwrite<RawEdge32<void>[]>(edge_count);
+    size_t vertex_count = 0;
+    if(!b32_dataset) {
+        vertex_count = load_dataset<RawEdge64<void>>(dataset, edge_buffer.get());
+    } else {
+        vertex_count = load_dataset<RawEdge32<void>>(dataset, edge_buffer.get());
+    }
+
+    // Batches must be new edges: keep each undirected edge once, without self loops
+    for(size_t i = 0; i < edge_count; i++) {
+        auto& e = edge_buffer[i];
+        e = RawEdge32<void>{std::min(e.from, e.to), std::max(e.from, e.to)};
+    }
+    auto by_vertices = [](const RawEdge32<void>& a, const RawEdge32<void>& b) {
+        return a.from < b.from || (a.from == b.from && a.to < b.to);
+    };
+    auto same_edge = [](const RawEdge32<void>& a, const RawEdge32<void>& b) {
+        return a.from == b.from && a.to == b.to;
+    };
+    std::sort(edge_buffer.get(), edge_buffer.get() + edge_count, by_vertices);
+    edge_count = std::unique(edge_buffer.get(), edge_buffer.get() + edge_count, same_edge) - edge_buffer.get();
+    edge_count = std::remove_if(edge_buffer.get(), edge_buffer.get() + edge_count, [](const RawEdge32<void>& e) {
+        return e.from == e.to;
+    }) - edge_buffer.get();
+
+    size_t thread_count = result.count("thread") ? result["thread"].as<size_t>() : GetLogicalCoreCount();
+    Config config = GenerateUGraphConfig(vertex_count, edge_count, thread_count);
+    fmt::println("Config:\n{}", config);
+    auto t_load = timer.Lap();
+
+    auto g = std::make_unique<UGraph32<void>>("./data/tmp_graph/", config);
+    if(result.count("relabel")) {
+        g->SetRelabeler(std::make_shared<const VertexRelabeler<VID32>>(VertexRelabeler<VID32>::FromSample(
+            std::span<const RawEdge32<void>>(edge_buffer.get(), edge_count), vertex_count, ParseRelabelOrder(result["relabel"].as<string>()))));
+    }
+
+    IncrementalTriangleCount<UGraph32<void>> itc;
+    size_t rounds = result["rounds"].as<size_t>();
+    size_t batch_size = result["batch_size"].as<size_t>();
+    double t_update = 0, t_full = 0;
+    size_t mismatch = 0;
+    size_t done = 0;
+    for(size_t r = 0; r < rounds; r++) {
+        size_t upto = (r + 1 == rounds) ? edge_count : edge_count / rounds * (r + 1);
+        for(size_t i = done; i < upto; i+=batch_size) {
+            size_t len = std::min(batch_size, upto - i);
+            g->AddEdgeBatch(std::span<const RawEdge32<void>>(edge_buffer.get() + i, len));
+        }
+        g->Collect();
+        g->WaitSortingAndPrepareAnalysis();
+        timer.Lap();
+
+        size_t added = itc.AddBatch(g.get(), std::span<const RawEdge32<void>>(edge_buffer.get() + done, upto - done));
+        auto t = timer.Lap();
+        t_update += t;
+        done = upto;
+
+        size_t full = tc_gapbs_cached(g.get());
+        t_full += timer.Lap();
+        mismatch += full != itc.Count();
+        fmt::println("Round {}: {} edges, {} new triangles, {:.3f}s, count: {} (full: {})", r, done, added, t, itc.Count(), full);
+        g->FinishAlgorithm();
+    }
+
+    fmt::println(EXPOUT "Dataset: {}", dataset.string());
+    fmt::println(EXPOUT "Vertex count: {}", vertex_count);
+    fmt::println(EXPOUT "Load: {:.3f}s", t_load);
+    fmt::println(EXPOUT "TC (incremental): {:.3f}s", t_update);
+    fmt::println(EXPOUT "TC (full): {:.3f}s", t_full);
+    return mismatch != 0;
+}
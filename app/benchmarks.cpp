@@ -1,3 +1,6 @@
+#include <limits>
+#include <numeric>
+#include <random>
 #include <omp.h>
 
 #include "cxxopts.hpp"
@@ -31,6 +34,40 @@ size_t load_dataset(const fs::path& dataset, RawEdge32<void>* edge_buffer) {
     return vertex_count;
 }
 
+// Out edges of vertices, looked up in parallel chunks by lookup(chunk, func), in order of thread
+template<typename Lookup>
+std::vector<std::pair<VID32, VID32>> lookup_edges(std::span<const VID32> vertices, const Lookup& lookup) {
+    constexpr size_t CHUNK = 4096;
+    std::vector<std::vector<std::pair<VID32, VID32>>> locals(omp_get_max_threads());
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(size_t i = 0; i < vertices.size(); i += CHUNK) {
+        auto& local = locals[omp_get_thread_num()];
+        lookup(vertices.subspan(i, std::min(CHUNK, vertices.size() - i)), [&](VID32 from, VID32 to) {
+            local.emplace_back(from, to);
+        });
+    }
+    std::vector<std::pair<VID32, VID32>> edges;
+    for(auto& local: locals) {
+        edges.insert(edges.end(), local.begin(), local.end());
+    }
+    return edges;
+}
+
+// Whether labels a and b group vertices the same way
+bool same_partition(const VID32* a, const VID32* b, size_t vertex_count) {
+    constexpr VID32 NONE = std::numeric_limits<VID32>::max();
+    std::vector<VID32> a_to_b(vertex_count, NONE), b_to_a(vertex_count, NONE);
+    for(size_t v = 0; v < vertex_count; v++) {
+        if(a_to_b[a[v]] == NONE && b_to_a[b[v]] == NONE) {
+            a_to_b[a[v]] = b[v];
+            b_to_a[b[v]] = a[v];
+        } else if(a_to_b[a[v]] != b[v] || b_to_a[b[v]] != a[v]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 int main(int argc, char** argv) {
     cxxopts::Options options("benchmarks", "Benchmarks for DCSR");
     options.add_options()
@@ -40,10 +77,24 @@ int main(int argc, char** argv) {
         ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
         ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
         ("u,sort_batch_size", "Sort batch size", cxxopts::value<size_t>())
+        ("gapbs_bfs", "Use direction optimizing BFS of GAP (parent output) instead of bfs")
+        ("msbfs", "Run the 20 BFS roots together by multi-source BFS")
+        ("interleaved", "Look up out edges of all vertices in random order by coroutines and by the prefetch pipeline, and compare")
+        ("pr_pb", "Use propagation blocking PageRank instead of pull (Gauss-Seidel)")
+        ("pr_bf16", "Keep PageRank contributions in bfloat16, last iteration in float")
+        ("stream_cc", "Maintain connected components while ingesting and check them against Afforest")
+        ("relabel", "Relabel vertices at ingest: degree, rcm or gorder", cxxopts::value<string>())
+        ("relabel_sample", "Number of first edges to compute the relabeling from", cxxopts::value<size_t>()->default_value("16777216"))
         ;
 
     auto result = options.parse(argc, argv);
     bool b32_dataset = result["b32"].as<bool>();
+    bool gapbs_bfs = result["gapbs_bfs"].as<bool>();
+    bool multi_source_bfs = result["msbfs"].as<bool>();
+    bool interleaved = result["interleaved"].as<bool>();
+    bool stream_cc = result["stream_cc"].as<bool>();
+    bool pr_pb = result["pr_pb"].as<bool>();
+    bool pr_bf16 = result["pr_bf16"].as<bool>();
     fs::path dataset = result["input"].as<string>();
     size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
     size_t edge_count = fs::file_size(dataset) / edge_size;
@@ -67,6 +118,7 @@ int main(int argc, char** argv) {
     if(result.count("sort_batch_size")) {
         config.sort_batch_size = result["sort_batch_size"].as<size_t>();
     }
+    config.stream_components = stream_cc;
 
     fmt::println("Dataset: {}", dataset.string());
     fmt::println("Physical cores: {}", GetPhysicalCoreCount());
@@ -84,6 +136,20 @@ int main(int argc, char** argv) {
     auto g = std::make_unique<TGraph32<void>>("./data/tmp_graph/", config);
     auto t_init = timer.Lap();
 
+    // Relabeling is computed from the first edges, then applied to all while dispatching
+    std::shared_ptr<const VertexRelabeler<VID32>> relabeler;
+    if(result.count("relabel")) {
+        size_t sample = std::min(edge_count, result["relabel_sample"].as<size_t>());
+        relabeler = std::make_shared<const VertexRelabeler<VID32>>(VertexRelabeler<VID32>::FromSample(
+            std::span<const RawEdge32<void>>(edge_buffer.get(), sample), vertex_count, ParseRelabelOrder(result["relabel"].as<string>())));
+        g->SetRelabeler(relabeler);
+        fmt::println("Relabel: {} from {} edges, {:.3f}s", result["relabel"].as<string>(), sample, timer.Lap());
+    }
+    // Original vertex v in the graph
+    auto vertex = [&](VID32 v) {
+        return relabeler ? relabeler->ToNew(v) : v;
+    };
+
     // for(size_t i = 0; i < edge_count; i++) {
     //     g->AddEdge(RawEdge32<void>{edge_buffer[i].from, edge_buffer[i].to});
     // }
@@ -143,16 +209,50 @@ int main(int argc, char** argv) {
     //     fmt::println("{}", v);
     // });
     // exit(0);
-    
-    for(size_t i = 0; i < 20; i++) {
-        bfs(g.get(), i);
+
+    if(interleaved) {
+        std::vector<VID32> vertices(vertex_count);
+        std::iota(vertices.begin(), vertices.end(), 0);
+        std::shuffle(vertices.begin(), vertices.end(), std::mt19937(27491095));
+        timer.Lap();
+        auto batch_edges = lookup_edges(vertices, [&](std::span<const VID32> chunk, const auto& func) {
+            g->IterateNeighborsOutBatch(chunk, func);
+        });
+        auto t_batch = timer.Lap();
+        auto interleaved_edges = lookup_edges(vertices, [&](std::span<const VID32> chunk, const auto& func) {
+            g->IterateNeighborsOutInterleaved(chunk, func);
+        });
+        auto t_interleaved = timer.Lap();
+        std::sort(batch_edges.begin(), batch_edges.end());
+        std::sort(interleaved_edges.begin(), interleaved_edges.end());
+        dcsr_assert(batch_edges == interleaved_edges, "Interleaved lookups differ from batch lookups");
+        fmt::println(EXPOUT "Lookup (batch): {:.3f}s", t_batch);
+        fmt::println(EXPOUT "Lookup (interleaved): {:.3f}s", t_interleaved);
+        timer.Lap();
+    }
+
+    if(multi_source_bfs) {
+        std::vector<VID32> roots(20);
+        std::iota(roots.begin(), roots.end(), 0);
+        std::transform(roots.begin(), roots.end(), roots.begin(), vertex);
+        msbfs<1>(g.get(), std::span<const VID32>(roots));
+    }
+    for(size_t i = 0; i < 20 && !multi_source_bfs; i++) {
+        if(gapbs_bfs) {
+            bfs_gapbs(g.get(), vertex(i));
+        } else {
+            bfs(g.get(), vertex(i));
+        }
     }
 
     auto rss_bfs = GetRSS();
     auto t_bfs = timer.Lap();
 
-    auto pr_result = pr_gapbs(g.get(), 10);
+    auto pr_result = pr_pb ? pr_gapbs_pb(g.get(), 10) : (pr_bf16 ? pr_gapbs_reduced(g.get(), 10) : pr_gapbs(g.get(), 10));
     auto t_pr = timer.Lap();
+    if(relabeler) {
+        pr_result = relabeler->ToOriginalOrder(pr_result.get(), vertex_count);
+    }
 
     using CCResult = decltype(cc_gapbs(g.get()));
     CCResult cc_result;
@@ -160,6 +260,11 @@ int main(int argc, char** argv) {
         cc_result = cc_gapbs(g.get());
     }
     auto t_cc = timer.Lap();
+    if(stream_cc) {
+        auto afforest = connected_components(g.get(), false);
+        dcsr_assert(same_partition(cc_result.get(), afforest.get(), vertex_count), "Maintained components differ from Afforest");
+        timer.Lap();
+    }
 
     g->FinishAlgorithm();
 
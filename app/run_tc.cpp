@@ -39,10 +39,12 @@ int main(int argc, char** argv) {
         ("b32", "Load 32 bit dataset. (Graph32 is always 32 bit, but you can load 64 bit dataset)")
         ("b,batch_size", "Ingesting batch size, to speed up dispatch", cxxopts::value<size_t>()->default_value("65536"))
         ("t,thread", "Number of threads to use for ingesting", cxxopts::value<size_t>())
+        ("intersect", "Also count by intersecting neighbor blocks in place (tc_gapbs_intersect) and compare, edges must not repeat")
         ;
 
     auto result = options.parse(argc, argv);
     bool b32_dataset = result["b32"].as<bool>();
+    bool intersect = result["intersect"].as<bool>();
     fs::path dataset = result["input"].as<string>();
     size_t edge_size = b32_dataset ? sizeof(RawEdge32<void>) : sizeof(RawEdge64<void>);
     size_t edge_count = fs::file_size(dataset) / edge_size;
@@ -104,6 +106,14 @@ int main(int argc, char** argv) {
 
     fmt::println("Triange count: {}", count);
 
+    size_t intersect_count = count;
+    double t_intersect = 0;
+    if(intersect) {
+        intersect_count = tc_gapbs_intersect(g.get());
+        t_intersect = timer.Lap();
+        fmt::println("Triange count (intersect): {}", intersect_count);
+    }
+
     g->FinishAlgorithm();
 
     fmt::println(EXPOUT "Dataset: {}", dataset.string());
@@ -112,6 +122,9 @@ int main(int argc, char** argv) {
     fmt::println(EXPOUT "Ingest: {:.3f}s", t_ingest);
     fmt::println("\t{:.3f}s (init) + {:.3f}s (insert) + {:.3f}s (wait)", t_init, t_insert, t_wait);
     fmt::println(EXPOUT "TC: {:.3f}s", t_tc);
+    if(intersect) {
+        fmt::println(EXPOUT "TC (intersect): {:.3f}s", t_intersect);
+    }
 
-    return 0;
+    return intersect_count != count;
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+/**
+ * @file search_policy.cpp
+ * @brief Micro benchmark of search policies (search_policy.h) on buckets of sorted runs.
+ * Pick the fastest one for current machine and use it as the Search parameter of
+ * Graph/UGraph/TGraph, e.g. TGraph32<void, BranchlessSearch>.
+ */
+#include <random>
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+#include "datatype.h"
+#include "metrics.h"
+#include "search_policy.h"
+
+using namespace dcsr;
+using namespace std;
+
+using EdgeType = RawEdge32<void>;
+
+struct BenchResult {
+    double seconds;
+    size_t checksum;
+};
+
+/**
+ * @brief Search random existing vertices in random buckets of `bucket` edges,
+ * the same as what partitions do after locating a bucket by group index.
+ */
+template<typename Policy>
+BenchResult RunPolicy(const vector<EdgeType>& edges, size_t bucket, const vector<size_t>& queries) {
+    size_t checksum = 0;
+    SimpleTimer timer;
+    for(size_t q: queries) {
+        size_t st = q / bucket * bucket;
+        size_t ed = std::min(st + bucket, edges.size());
+        const EdgeType* first = edges.data() + st;
+        const EdgeType* last = edges.data() + ed;
+        auto it = Policy::LowerBound(first, last, edges[q], CmpFrom<EdgeType>());
+        checksum += it - first;
+    }
+    return {timer.Stop(), checksum};
+}
+
+template<typename... Policies>
+void RunAll(const vector<EdgeType>& edges, const vector<size_t>& buckets, const vector<size_t>& queries) {
+    fmt::print("{:>10}", "bucket");
+    ((fmt::print("{:>12}", Policies::name)), ...);
+    fmt::println("{:>12}", "best");
+
+    for(size_t bucket: buckets) {
+        vector<BenchResult> results = {RunPolicy<Policies>(edges, bucket, queries)...};
+        vector<const char*> names = {Policies::name...};
+        size_t best = 0;
+        fmt::print("{:>10}", bucket);
+        for(size_t i = 0; i < results.size(); i++) {
+            if(results[i].checksum != results[0].checksum) {
+                fmt::println("\nPolicy {} returned different result", names[i]);
+                exit(1);
+            }
+            if(results[i].seconds < results[best].seconds) {
+                best = i;
+            }
+            fmt::print("{:>10.1f}ns", results[i].seconds * 1e9 / queries.size());
+        }
+        fmt::println("{:>12}", names[best]);
+    }
+}
+
+int main(int argc, char** argv) {
+    cxxopts::Options options("search_policy", "Benchmark search policies for sorted runs");
+    options.add_options()
+        ("h,help", "Print help")
+        ("e,edges", "Edges in the sorted run", cxxopts::value<size_t>()->default_value("67108864"))
+        ("v,vertices", "Vertices of the run", cxxopts::value<size_t>()->default_value("4194304"))
+        ("q,queries", "Queries per bucket size", cxxopts::value<size_t>()->default_value("4194304"))
+        ("b,buckets", "Bucket sizes to test", cxxopts::value<vector<size_t>>()->default_value("16,128,1024,8192,65536,1048576"))
+    ;
+    auto result = options.parse(argc, argv);
+    if(result.count("help")) {
+        fmt::println("{}", options.help());
+        return 0;
+    }
+
+    size_t edge_count = result["edges"].as<size_t>();
+    size_t vertex_count = result["vertices"].as<size_t>();
+    size_t query_count = result["queries"].as<size_t>();
+    auto buckets = result["buckets"].as<vector<size_t>>();
+
+    mt19937_64 gen(0);
+    uniform_int_distribution<VID32> vdis(0, vertex_count - 1);
+    vector<EdgeType> edges(edge_count);
+    for(auto& e: edges) {
+        e = EdgeType(vdis(gen), vdis(gen));
+    }
+    sort(edges.begin(), edges.end(), CmpFrom<EdgeType>());
+
+    uniform_int_distribution<size_t> qdis(0, edge_count - 1);
+    vector<size_t> queries(query_count);
+    for(auto& q: queries) {
+        q = qdis(gen);
+    }
+
+    fmt::println("Run: {} edges, {} vertices, {} queries per bucket size", edge_count, vertex_count, query_count);
+#if defined(__x86_64__)
+    RunAll<StdSearch, SbSearch, SbmSearch, SbpmSearch, BranchlessSearch, AsmSearch>(edges, buckets, queries);
+#else
+    RunAll<StdSearch, SbSearch, SbmSearch, SbpmSearch, BranchlessSearch>(edges, buckets, queries);
+#endif
+    return 0;
+}
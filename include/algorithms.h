@@ -1,10 +1,19 @@
 #ifndef __DCSR_ALGORITHMS_H__
 #define __DCSR_ALGORITHMS_H__
 
+#include "algorithms/bc.h"
 #include "algorithms/bfs.h"
 #include "algorithms/cc.h"
+#include "algorithms/community.h"
+#include "algorithms/kcore.h"
+#include "algorithms/ligra.h"
+#include "algorithms/msbfs.h"
 #include "algorithms/pr.h"
+#include "algorithms/pr_incremental.h"
+#include "algorithms/ppr.h"
+#include "algorithms/random_walk.h"
 #include "algorithms/tc.h"
+#include "algorithms/tc_incremental.h"
 
 #include "algorithms/gapbs/bfs.h"
 #include "algorithms/gapbs/pr.h"
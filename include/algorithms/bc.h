@@ -0,0 +1,159 @@
+#ifndef __DCSR_BC_H__
+#define __DCSR_BC_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include "concepts.h"
+#include "env/memory.h"
+#include "algorithms/msbfs.h"
+
+namespace dcsr {
+
+/**
+ * @brief Betweenness centrality by Brandes' algorithm, sources processed in tiles of up to 64 * W.
+ * Forward phase is the direction optimizing MultiSourceBFS of the tile, a vertex reached at
+ * level l pulls its shortest path counts over IterateNeighborsIn from the predecessors at level
+ * l - 1 of the same sources. Backward phase goes level by level from the deepest, each vertex
+ * pulls dependencies from its successors (IterateNeighborsOut, depth l + 1) of the sources that
+ * reached it at l, so a vertex's entries are only written by the thread handling it, no atomics.
+ * Memory: path count, dependency and depth take 14 bytes per vertex and source of the tile, in
+ * huge pages (v_count * 896 * W bytes for a full tile). The tile is narrowed so this stays within
+ * memory_budget, down to one source (14 bytes per vertex). Per-level lists of reached vertices add
+ * one entry (vertex and mask, 8 + 8 * W bytes) per vertex and level of the tile.
+ * source_count == 0 (or >= v_count) is exact. Otherwise source_count sources are sampled
+ * uniformly with seed and scores are scaled by v_count / source_count. Each tile is a traversal
+ * of the part of the graph its sources reach, so the time grows with source_count / tile times
+ * the edge count: pick source_count for the time budget on large graphs.
+ * bc_sources sums dependencies of the given sources times scale, bc below picks the sources.
+ */
+template<size_t W = 1, ConditionalStopIterableTwoWayGraph GraphType>
+std::unique_ptr<float[]> bc_sources(const GraphType* graph, std::span<const typename GraphType::VertexType> sources,
+                                    float scale = 1, size_t memory_budget = size_t(16) << 30) {
+    using VID = typename GraphType::VertexType;
+    using Mask = SourceMask<W>;
+    constexpr size_t BATCH = 64 * W;
+    constexpr size_t ENTRY_BYTES = sizeof(double) + sizeof(float) + sizeof(uint16_t);   // sigma, delta, depth
+    constexpr uint16_t UNREACHED = std::numeric_limits<uint16_t>::max();
+
+    size_t v_count = graph->VertexCount();
+    size_t threads = omp_get_max_threads();
+    const size_t tile = std::clamp<size_t>(memory_budget / (ENTRY_BYTES * std::max<size_t>(v_count, 1)), 1, BATCH);
+
+    auto scores = std::make_unique<float[]>(v_count);
+    auto sigma = make_huge_for_overwrite<double[]>(v_count * tile);
+    auto delta = make_huge_for_overwrite<float[]>(v_count * tile);
+    auto depth = make_huge_for_overwrite<uint16_t[]>(v_count * tile);
+    #pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < v_count * tile; i++) {
+        depth[i] = UNREACHED;
+    }
+
+    // Vertices reached at each level with their sources, per thread
+    using Entry = std::pair<VID, Mask>;
+    std::vector<std::vector<std::vector<Entry>>> reached(threads);
+
+    for(size_t first = 0; first < sources.size(); first += tile) {
+        auto roots = sources.subspan(first, std::min(tile, sources.size() - first));
+
+        MultiSourceBFS<W>(graph, roots, [&](VID v, size_t level, const Mask& mask) {
+            dcsr_assert(level < UNREACHED, "BFS too deep for bc");
+            size_t base = size_t(v) * tile;
+            mask.ForEach([&](size_t i) {
+                depth[base + i] = level;
+                delta[base + i] = 0;
+                sigma[base + i] = level == 0;
+            });
+            if(level != 0) {
+                graph->IterateNeighborsIn(v, [&](VID u) {
+                    size_t from = size_t(u) * tile;
+                    mask.ForEach([&](size_t i) {
+                        if(depth[from + i] == level - 1) {
+                            sigma[base + i] += sigma[from + i];
+                        }
+                    });
+                });
+            }
+            auto& local = reached[omp_get_thread_num()];
+            if(local.size() <= level) {
+                local.resize(level + 1);
+            }
+            local[level].emplace_back(v, mask);
+        });
+
+        size_t levels = 0;
+        for(auto& local: reached) {
+            levels = std::max(levels, local.size());
+        }
+        // Roots have no dependency, vertices of the deepest level neither
+        std::vector<Entry> frontier;
+        for(size_t level = levels - 1; level-- > 1; ) {
+            frontier.clear();
+            for(auto& local: reached) {
+                if(level < local.size()) {
+                    frontier.insert(frontier.end(), local[level].begin(), local[level].end());
+                }
+            }
+            #pragma omp parallel for schedule(dynamic, 64)
+            for(size_t j = 0; j < frontier.size(); j++) {
+                auto& [v, mask] = frontier[j];
+                size_t base = size_t(v) * tile;
+                graph->IterateNeighborsOut(v, [&](VID w) {
+                    size_t to = size_t(w) * tile;
+                    mask.ForEach([&](size_t i) {
+                        if(depth[to + i] == level + 1) {
+                            delta[base + i] += sigma[base + i] / sigma[to + i] * (1 + delta[to + i]);
+                        }
+                    });
+                });
+                float sum = 0;
+                mask.ForEach([&](size_t i) {
+                    sum += delta[base + i];
+                });
+                scores[v] += sum * scale;
+            }
+        }
+
+        // Clear depths of this batch
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(size_t t = 0; t < threads; t++) {
+            for(auto& entries: reached[t]) {
+                for(auto& [v, mask]: entries) {
+                    mask.ForEach([&](size_t i) {
+                        depth[size_t(v) * tile + i] = UNREACHED;
+                    });
+                }
+            }
+            reached[t].clear();
+        }
+    }
+    return scores;
+}
+
+template<size_t W = 1, ConditionalStopIterableTwoWayGraph GraphType>
+std::unique_ptr<float[]> bc(const GraphType* graph, size_t source_count = 0, uint64_t seed = 27491095,
+                            size_t memory_budget = size_t(16) << 30) {
+    using VID = typename GraphType::VertexType;
+    size_t v_count = graph->VertexCount();
+    std::vector<VID> sources(v_count);
+    std::iota(sources.begin(), sources.end(), VID(0));
+    if(source_count != 0 && source_count < v_count) {
+        std::vector<VID> sampled;
+        sampled.reserve(source_count);
+        std::sample(sources.begin(), sources.end(), std::back_inserter(sampled), source_count, std::mt19937_64(seed));
+        sources = std::move(sampled);
+    }
+    float scale = float(v_count) / std::max<size_t>(sources.size(), 1);
+    return bc_sources<W>(graph, std::span<const VID>(sources), scale, memory_budget);
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_BC_H__
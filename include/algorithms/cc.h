@@ -8,42 +8,10 @@
 #include <boost/dynamic_bitset.hpp>
 #include "concepts.h"
 #include "metrics.h"
+#include "union_find.h"
 
 namespace dcsr {
 
-template<typename T>
-bool compare_and_swap(T &x, const T &old_val, const T &new_val) {
-    return __sync_bool_compare_and_swap(&x, old_val, new_val);
-}
-
-// Place nodes u and v in same component of lower component ID
-template<typename NodeID>
-void Link(NodeID u, NodeID v, NodeID* comp) {
-    NodeID p1 = comp[u];
-    NodeID p2 = comp[v];
-    while (p1 != p2) {
-        NodeID high = p1 > p2 ? p1 : p2;
-        NodeID low = p1 + (p2 - high);
-        NodeID p_high = comp[high];
-        // Was already 'low' or succeeded in writing 'low'
-        if ((p_high == low) || (p_high == high && compare_and_swap(comp[high], high, low)))
-            break;
-        p1 = comp[comp[high]]; // Union-Find ? path compression?
-        p2 = comp[low];
-    }
-}
-
-// Reduce depth of tree for each component to 1 by crawling up parents
-template<typename NodeID>
-void Compress(std::span<NodeID> comp) {
-  #pragma omp parallel for schedule(dynamic, 16384)
-  for (NodeID n = 0; n < comp.size(); n++) {
-    while (comp[n] != comp[comp[n]]) {
-      comp[n] = comp[comp[n]];
-    }
-  }
-}
-
 template<typename NodeID>
 NodeID SampleFrequentElement(const NodeID* comp, NodeID v_count, bool logging=false, size_t num_samples=1024) {
     std::unordered_map<NodeID, int> sample_counts(32);
@@ -523,10 +491,23 @@ auto connected_components(GraphType* graph, bool logging, size_t neighbor_rounds
     return comp_uptr;
 }
 
+// Labels maintained while ingesting if the graph has them (O(V) compress and copy), else Afforest
 template<ConditionalStopIterableTwoWayGraph GraphType>
 auto cc_gapbs(GraphType* graph, size_t neighbor_rounds = 2) {
+    using NodeID = GraphType::VertexType;
+    if constexpr (requires { graph->MaintainedComponents(); }) {
+        if(auto* components = graph->MaintainedComponents(); components != nullptr) {
+            auto labels = components->Labels();
+            auto comp = std::make_unique_for_overwrite<NodeID[]>(labels.size());
+            #pragma omp parallel for schedule(static, 16384)
+            for (size_t v = 0; v < labels.size(); v++) {
+                comp[v] = labels[v];
+            }
+            return comp;
+        }
+    }
     return connected_components(graph, false, neighbor_rounds);
-} 
+}
 
 } // namespace dcsr
 
@@ -0,0 +1,276 @@
+#ifndef __DCSR_COMMUNITY_H__
+#define __DCSR_COMMUNITY_H__
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <numa.h>
+#include <omp.h>
+#include <sched.h>
+#include "concepts.h"
+#include "algorithms/open_hash_map.h"
+
+namespace dcsr {
+
+/**
+ * @brief Parallel loop over vertices grouped by memory partition. Threads claim chunks of the
+ * partitions on their own NUMA node first (each thread starting at a different one), then help
+ * with the remaining partitions, so neighbor lists are mostly read from local memory.
+ */
+template<typename GraphType>
+class PartitionOrderedLoop {
+private:
+    static constexpr size_t CHUNK = 1024;
+    std::vector<std::pair<size_t, size_t>> ranges_;
+    std::vector<int> nodes_;
+
+public:
+    explicit PartitionOrderedLoop(const GraphType& graph) {
+        size_t v_count = graph.VertexCount();
+        size_t parts = graph.MemPartitionCount();
+        // Partitions hold consecutive vertex ranges, find the first vertex of each
+        std::vector<size_t> bounds(parts + 1, v_count);
+        for(size_t p = 0; p < parts; p++) {
+            size_t lo = 0, hi = v_count;
+            while(lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if(graph.PartitionOf(mid) < p) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            bounds[p] = lo;
+        }
+        for(size_t p = 0; p < parts; p++) {
+            ranges_.emplace_back(bounds[p], bounds[p + 1]);
+            nodes_.push_back(graph.PartitionNumaNode(p));
+        }
+    }
+
+    // Call f(v) for each vertex in parallel
+    template<typename Func>
+    void ForEach(const Func& f) const {
+        size_t parts = ranges_.size();
+        auto cursors = std::make_unique<std::atomic<size_t>[]>(parts);
+        for(size_t p = 0; p < parts; p++) {
+            cursors[p] = ranges_[p].first;
+        }
+        #pragma omp parallel
+        {
+            int node = numa_node_of_cpu(sched_getcpu());
+            size_t tid = omp_get_thread_num();
+            std::vector<size_t> order;
+            for(bool local: {true, false}) {
+                for(size_t k = 0; k < parts; k++) {
+                    size_t p = (tid + k) % parts;
+                    if((nodes_[p] == node) == local) {
+                        order.push_back(p);
+                    }
+                }
+            }
+            for(size_t p: order) {
+                size_t ed = ranges_[p].second;
+                for(size_t st = cursors[p].fetch_add(CHUNK, std::memory_order_relaxed); st < ed;
+                    st = cursors[p].fetch_add(CHUNK, std::memory_order_relaxed)) {
+                    for(size_t v = st; v < std::min(st + CHUNK, ed); v++) {
+                        f(v);
+                    }
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief Parallel (asynchronous) label propagation. Each vertex takes the most frequent label
+ * among its neighbors, counted in a per-thread open addressing map; on ties it keeps its label,
+ * otherwise the smallest label wins. Only vertices with a neighbor changed in the last pass are
+ * visited again, and it stops when at most tolerance * v_count labels change in a pass.
+ */
+template<UndirectedGraph UGraphType>
+std::unique_ptr<typename UGraphType::VertexType[]> label_propagation(const UGraphType* graph, size_t max_iterations = 20, double tolerance = 0.05) {
+    using VID = typename UGraphType::VertexType;
+    const auto& g = graph->GraphView();
+    size_t v_count = g.VertexCount();
+    size_t threads = omp_get_max_threads();
+    PartitionOrderedLoop loop(g);
+
+    auto labels = std::make_unique_for_overwrite<VID[]>(v_count);
+    auto done = std::make_unique<uint8_t[]>(v_count);     // no neighbor changed since last visit
+    #pragma omp parallel for schedule(static)
+    for(size_t v = 0; v < v_count; v++) {
+        labels[v] = v;
+    }
+
+    std::vector<OpenHashMap<VID, uint32_t>> maps(threads);
+    std::vector<size_t> changed(threads);
+    for(size_t iter = 0; iter < max_iterations; iter++) {
+        std::fill(changed.begin(), changed.end(), 0);
+        loop.ForEach([&](VID v) {
+            if(std::atomic_ref<uint8_t>(done[v]).load(std::memory_order_relaxed)) {
+                return;
+            }
+            std::atomic_ref<uint8_t>(done[v]).store(1, std::memory_order_relaxed);
+            size_t tid = omp_get_thread_num();
+            auto& map = maps[tid];
+            map.Clear();
+            g.IterateNeighbors(v, [&](VID w) {
+                if(w != v) {
+                    map[std::atomic_ref<VID>(labels[w]).load(std::memory_order_relaxed)]++;
+                }
+            });
+            VID cur = labels[v];
+            VID best = cur;
+            uint32_t best_count = map.Get(cur);
+            map.ForEach([&](VID label, uint32_t count) {
+                if(count > best_count || (count == best_count && best != cur && label < best)) {
+                    best = label;
+                    best_count = count;
+                }
+            });
+            if(best == cur) {
+                return;
+            }
+            std::atomic_ref<VID>(labels[v]).store(best, std::memory_order_relaxed);
+            changed[tid]++;
+            g.IterateNeighbors(v, [&](VID w) {
+                std::atomic_ref<uint8_t>(done[w]).store(0, std::memory_order_relaxed);
+            });
+        });
+        size_t total = 0;
+        for(auto c: changed) {
+            total += c;
+        }
+        if(total <= tolerance * v_count) {
+            break;
+        }
+    }
+    return labels;
+}
+
+/**
+ * @brief First phase of Louvain (local moving) on the unweighted graph, in parallel. Each vertex
+ * moves to the neighboring community of largest modularity gain
+ *   (k_{v,c} - k_{v,d}) / m - K_v * (S_c - S_d + K_v) / (2 m^2)
+ * (d its community, k_{v,c} edges from v to c, K_v its degree, S_c total degree of c), with
+ * k_{v,c} accumulated in a per-thread open addressing map and S updated atomically. Vertices are
+ * revisited only when a neighbor moved; it stops when a pass gains less than tolerance.
+ * Returns the community of each vertex (a vertex ID).
+ */
+template<UndirectedGraph UGraphType>
+std::unique_ptr<typename UGraphType::VertexType[]> louvain_local_moving(const UGraphType* graph, size_t max_iterations = 20, double tolerance = 1e-6) {
+    using VID = typename UGraphType::VertexType;
+    const auto& g = graph->GraphView();
+    size_t v_count = g.VertexCount();
+    size_t threads = omp_get_max_threads();
+    PartitionOrderedLoop loop(g);
+
+    auto community = std::make_unique_for_overwrite<VID[]>(v_count);
+    auto degree = std::make_unique_for_overwrite<double[]>(v_count);
+    auto total = std::make_unique_for_overwrite<double[]>(v_count);     // S_c
+    auto done = std::make_unique<uint8_t[]>(v_count);
+    double m2 = 0;
+    #pragma omp parallel for schedule(dynamic, 16384) reduction(+:m2)
+    for(size_t v = 0; v < v_count; v++) {
+        community[v] = v;
+        degree[v] = g.GetDegree(v);
+        total[v] = degree[v];
+        m2 += degree[v];
+    }
+    if(m2 == 0) {
+        return community;
+    }
+    double m = m2 / 2;
+
+    std::vector<OpenHashMap<VID, uint32_t>> maps(threads);
+    std::vector<double> gains(threads);
+    for(size_t iter = 0; iter < max_iterations; iter++) {
+        std::fill(gains.begin(), gains.end(), 0);
+        loop.ForEach([&](VID v) {
+            if(std::atomic_ref<uint8_t>(done[v]).load(std::memory_order_relaxed)) {
+                return;
+            }
+            std::atomic_ref<uint8_t>(done[v]).store(1, std::memory_order_relaxed);
+            size_t tid = omp_get_thread_num();
+            auto& map = maps[tid];
+            map.Clear();
+            g.IterateNeighbors(v, [&](VID w) {
+                if(w != v) {
+                    map[std::atomic_ref<VID>(community[w]).load(std::memory_order_relaxed)]++;
+                }
+            });
+            VID d = community[v];
+            double k = degree[v];
+            double k_d = map.Get(d);
+            double s_d = std::atomic_ref<double>(total[d]).load(std::memory_order_relaxed);
+            VID best = d;
+            double best_gain = 0;
+            map.ForEach([&](VID c, uint32_t k_c) {
+                if(c == d) {
+                    return;
+                }
+                double s_c = std::atomic_ref<double>(total[c]).load(std::memory_order_relaxed);
+                double gain = (k_c - k_d) / m - k * (s_c - s_d + k) / (2 * m * m);
+                if(gain > best_gain) {
+                    best = c;
+                    best_gain = gain;
+                }
+            });
+            if(best == d) {
+                return;
+            }
+            std::atomic_ref<double>(total[d]).fetch_sub(k, std::memory_order_relaxed);
+            std::atomic_ref<double>(total[best]).fetch_add(k, std::memory_order_relaxed);
+            std::atomic_ref<VID>(community[v]).store(best, std::memory_order_relaxed);
+            gains[tid] += best_gain;
+            g.IterateNeighbors(v, [&](VID w) {
+                std::atomic_ref<uint8_t>(done[w]).store(0, std::memory_order_relaxed);
+            });
+        });
+        double gain = 0;
+        for(auto x: gains) {
+            gain += x;
+        }
+        if(gain < tolerance) {
+            break;
+        }
+    }
+    return community;
+}
+
+// Modularity of a vertex partition of the unweighted graph
+template<UndirectedGraph UGraphType>
+double modularity(const UGraphType* graph, const typename UGraphType::VertexType* community) {
+    using VID = typename UGraphType::VertexType;
+    const auto& g = graph->GraphView();
+    size_t v_count = g.VertexCount();
+    auto total = std::make_unique<double[]>(v_count);
+    double internal = 0, m2 = 0;
+    #pragma omp parallel for schedule(dynamic, 16384) reduction(+:internal, m2)
+    for(size_t v = 0; v < v_count; v++) {
+        size_t degree = 0;
+        g.IterateNeighbors(v, [&](VID w) {
+            internal += community[w] == community[v];
+            degree++;
+        });
+        m2 += degree;
+        std::atomic_ref<double>(total[community[v]]).fetch_add(degree, std::memory_order_relaxed);
+    }
+    if(m2 == 0) {
+        return 0;
+    }
+    double q = internal / m2;
+    #pragma omp parallel for schedule(static) reduction(-:q)
+    for(size_t c = 0; c < v_count; c++) {
+        q -= (total[c] / m2) * (total[c] / m2);
+    }
+    return q;
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_COMMUNITY_H__
@@ -0,0 +1,204 @@
+// Copyright (c) 2015, The Regents of the University of California (Regents)
+// See LICENSE.txt for license details
+
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+#include "concepts.h"
+#include "bitmap.h"
+#include "sliding_queue.h"
+
+/*
+GAP Benchmark Suite
+Kernel: Breadth-First Search (BFS)
+Author: Scott Beamer
+
+Will return parent array for a BFS traversal from a source vertex
+
+This BFS implementation makes use of the Direction-Optimizing approach [1].
+It uses the alpha and beta parameters to determine whether to switch search
+directions. For representing the frontier, it uses a SlidingQueue for the
+top-down approach and a Bitmap for the bottom-up approach. To reduce
+false-sharing for the top-down approach, thread-local QueueBuffer's are used.
+
+To save time computing the number of edges exiting the frontier, this
+implementation precomputes the degrees in bulk at the beginning by storing
+them in parent array as negative numbers. Thus the encoding of parent is:
+  parent[x] < 0 implies x is unvisited and parent[x] = -out_degree(x)
+  parent[x] >= 0 implies x been visited
+
+The top-down step looks up neighbors of a chunk of the queue at once
+(IterateNeighborsOutBatch), so cache misses of the index lookups overlap.
+
+[1] Scott Beamer, Krste Asanović, and David Patterson. "Direction-Optimizing
+    Breadth-First Search." International Conference on High Performance
+    Computing, Networking, Storage and Analysis (SC), Salt Lake City, Utah,
+    November 2012.
+*/
+
+
+// Frontier vertices looked up by one IterateNeighborsOutBatch call
+const size_t kTDChunk = 64;
+
+template <typename TGraph, typename SNodeID>
+    requires dcsr::ConditionalStopIterableTwoWayGraph<TGraph>
+int64_t BUStep(const TGraph &g, SNodeID *parent, Bitmap &front, Bitmap &next) {
+    using NodeID = typename TGraph::VertexType;
+    const size_t v_count = g.VertexCount();
+    int64_t awake_count = 0;
+    next.reset();
+    #pragma omp parallel for reduction(+ : awake_count) schedule(dynamic, 1024)
+    for (size_t u=0; u < v_count; u++) {
+        if (parent[u] < 0) {
+            g.IterateNeighborsIn(u, [&](NodeID v) {
+                if (front.get_bit(v)) {
+                    parent[u] = v;
+                    awake_count++;
+                    next.set_bit(u);
+                    return false;
+                }
+                return true;
+            });
+        }
+    }
+    return awake_count;
+}
+
+
+template <typename TGraph, typename SNodeID>
+    requires dcsr::ConditionalStopIterableTwoWayGraph<TGraph>
+int64_t TDStep(const TGraph &g, SNodeID *parent, SlidingQueue<typename TGraph::VertexType> &queue) {
+    using NodeID = typename TGraph::VertexType;
+    int64_t scout_count = 0;
+    #pragma omp parallel
+    {
+        QueueBuffer<NodeID> lqueue(queue);
+        // Lambda is outside the reduction loop, count in a thread local and combine once
+        int64_t local_scout = 0;
+        auto visit = [&](NodeID u, NodeID v) {
+            SNodeID curr_val = parent[v];
+            if (curr_val < 0) {
+                if (::compare_and_swap(parent[v], curr_val, static_cast<SNodeID>(u))) {
+                    lqueue.push_back(v);
+                    local_scout += -curr_val;
+                }
+            }
+        };
+        #pragma omp for nowait schedule(dynamic, 1)
+        for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter += kTDChunk) {
+            size_t len = std::min<size_t>(kTDChunk, queue.end() - q_iter);
+            if constexpr (dcsr::BatchIterableTwoWayGraph<TGraph>) {
+                g.IterateNeighborsOutBatch(std::span<const NodeID>(q_iter, len), visit);
+            } else {
+                for (size_t i = 0; i < len; i++) {
+                    NodeID u = q_iter[i];
+                    g.IterateNeighborsOut(u, [&](NodeID v) { visit(u, v); });
+                }
+            }
+        }
+        lqueue.flush();
+        #pragma omp atomic
+        scout_count += local_scout;
+    }
+    return scout_count;
+}
+
+
+template <typename NodeID>
+void QueueToBitmap(const SlidingQueue<NodeID> &queue, Bitmap &bm) {
+    #pragma omp parallel for
+    for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++) {
+        NodeID u = *q_iter;
+        bm.set_bit_atomic(u);
+    }
+}
+
+template <typename NodeID>
+void BitmapToQueue(size_t v_count, const Bitmap &bm, SlidingQueue<NodeID> &queue) {
+    #pragma omp parallel
+    {
+        QueueBuffer<NodeID> lqueue(queue);
+        #pragma omp for nowait
+        for (size_t n=0; n < v_count; n++)
+            if (bm.get_bit(n))
+                lqueue.push_back(n);
+        lqueue.flush();
+    }
+    queue.slide_window();
+}
+
+template <typename TGraph>
+    requires dcsr::ConditionalStopIterableTwoWayGraph<TGraph>
+auto InitParent(const TGraph &g) {
+    using SNodeID = std::make_signed_t<typename TGraph::VertexType>;
+    const size_t v_count = g.VertexCount();
+    auto parent = std::make_unique_for_overwrite<SNodeID[]>(v_count);
+    #pragma omp parallel for
+    for (size_t n=0; n < v_count; n++) {
+        SNodeID degree = g.GetDegreeOut(n);
+        parent[n] = degree != 0 ? -degree : -1;
+    }
+    return parent;
+}
+
+template <typename TGraph>
+    requires dcsr::ConditionalStopIterableTwoWayGraph<TGraph>
+auto DOBFS(const TGraph &g, typename TGraph::VertexType source, int alpha = 15, int beta = 18, bool logging_enabled = false) {
+    using NodeID = typename TGraph::VertexType;
+    const size_t v_count = g.VertexCount();
+    if (logging_enabled)
+        fmt::println("Source: {}", source);
+    auto parent = InitParent(g);
+    parent[source] = source;
+    SlidingQueue<NodeID> queue(v_count);
+    queue.push_back(source);
+    queue.slide_window();
+    Bitmap curr(v_count);
+    curr.reset();
+    Bitmap front(v_count);
+    front.reset();
+    int64_t edges_to_check = g.EdgeCount();
+    int64_t scout_count = g.GetDegreeOut(source);
+    while (!queue.empty()) {
+        if (scout_count > edges_to_check / alpha) {
+            SimpleTimer t;
+            int64_t awake_count, old_awake_count;
+            QueueToBitmap(queue, front);
+            awake_count = queue.size();
+            queue.slide_window();
+            do {
+                old_awake_count = awake_count;
+                awake_count = BUStep(g, parent.get(), front, curr);
+                front.swap(curr);
+                if (logging_enabled)
+                    fmt::println("  bu {} {:.5f}s", awake_count, t.Lap());
+            } while ((awake_count >= old_awake_count) ||
+                     (awake_count > static_cast<int64_t>(v_count) / beta));
+            BitmapToQueue(v_count, front, queue);
+            scout_count = 1;
+        } else {
+            SimpleTimer t;
+            edges_to_check -= scout_count;
+            scout_count = TDStep(g, parent.get(), queue);
+            queue.slide_window();
+            if (logging_enabled)
+                fmt::println("  td {} {:.5f}s", queue.size(), t.Stop());
+        }
+    }
+    #pragma omp parallel for
+    for (size_t n = 0; n < v_count; n++)
+        if (parent[n] < -1)
+            parent[n] = -1;
+    return parent;
+}
+
+
+// Parent of each vertex (-1 for unreachable, source is parent of itself)
+template <typename TGraph>
+    requires dcsr::ConditionalStopIterableTwoWayGraph<TGraph>
+auto bfs_gapbs(const TGraph *g, typename TGraph::VertexType source) {
+    return DOBFS(*g, source);
+}
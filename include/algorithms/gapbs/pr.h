@@ -5,6 +5,8 @@
 #include <memory>
 
 #include "concepts.h"
+#include "reduced_precision.h"
+#include "algorithms/pr.h"
 
 /*
 GAP Benchmark Suite
@@ -22,6 +24,62 @@ implementation is still available in src/pr_spmv.cc.
 using ScoreT = float;
 const float kDamp = 0.85;
 
+// One Gauss-Seidel iteration in blocks of VBATCH vertices, returns total change of scores.
+// ContribT may be narrower than ScoreT (read at random), sums are in ScoreT.
+template <typename TGraph, typename ContribT, typename DegreeFunc>
+    requires dcsr::BasicIterableTwoWayGraph<TGraph>
+double PullGSIteration(const TGraph &g, ScoreT* scores, ContribT* outgoing_contrib, const DegreeFunc& degree, ScoreT base_score) {
+    using NodeID = typename TGraph::VertexType;
+    const size_t v_count = g.VertexCount();
+    double error = 0;
+
+    constexpr size_t VBATCH = 16384;
+    // #pragma omp parallel for reduction(+ : error) schedule(dynamic, VBATCH)
+    // for (NodeID u=0; u < v_count; u++) {
+    //     ScoreT incoming_total = 0;
+
+    //     g.IterateNeighborsIn(u, [&](NodeID v) {
+    //         incoming_total += outgoing_contrib[v];
+    //     });
+
+    //     ScoreT old_score = scores[u];
+    //     scores[u] = base_score + kDamp * incoming_total;
+        
+    //     error += fabs(scores[u] - old_score);
+    //     // outgoing_contrib[u] = scores[u] / g.GetDegreeOut(u);
+    //     outgoing_contrib[u] = scores[u] / degree_cache[u];
+    // }
+
+    #pragma omp parallel for reduction(+ : error) schedule(dynamic, 1)
+    for (NodeID u1 = 0; u1 < v_count; u1 += VBATCH) {
+        NodeID u2 = std::min(u1 + VBATCH, v_count);
+        auto incoming_total = std::make_unique<ScoreT[]>(u2 - u1);
+        memset(incoming_total.get(), 0, sizeof(ScoreT) * (u2 - u1));
+
+        if constexpr (dcsr::SpanIterableTwoWayGraph<TGraph>) {
+            // Contiguous blocks, no per-edge callback, loop can be unrolled
+            g.IterateNeighborSpansInRange(u1, u2, [&](std::span<const typename TGraph::EdgeType> edges) {
+                for(const auto& e: edges) {
+                    incoming_total[e.from - u1] += static_cast<ScoreT>(outgoing_contrib[e.to]);
+                }
+            });
+        } else {
+            g.IterateNeighborsInRange(u1, u2, [&](NodeID u, NodeID v) {
+                incoming_total[u - u1] += static_cast<ScoreT>(outgoing_contrib[v]);
+            });
+        }
+
+        for(NodeID u = u1; u < u2; u++) {
+            ScoreT old_score = scores[u];
+            scores[u] = base_score + kDamp * incoming_total[u - u1];
+            error += fabs(scores[u] - old_score);
+            // outgoing_contrib[u] = scores[u] / g.GetDegreeOut(u);
+            outgoing_contrib[u] = scores[u] / degree(u);
+        }
+    }
+    return error;
+}
+
 template <typename TGraph>
     requires dcsr::BasicIterableTwoWayGraph<TGraph>
 ScoreT* PageRankPullGS(const TGraph &g, int max_iters, double epsilon=0, bool logging_enabled = false) {
@@ -52,43 +110,109 @@ ScoreT* PageRankPullGS(const TGraph &g, int max_iters, double epsilon=0, bool lo
 
     for (int iter=0; iter < max_iters; iter++) {
         SimpleTimer t;
-        double error = 0;
-
-        constexpr size_t VBATCH = 16384;
-        // #pragma omp parallel for reduction(+ : error) schedule(dynamic, VBATCH)
-        // for (NodeID u=0; u < v_count; u++) {
-        //     ScoreT incoming_total = 0;
-
-        //     g.IterateNeighborsIn(u, [&](NodeID v) {
-        //         incoming_total += outgoing_contrib[v];
-        //     });
-
-        //     ScoreT old_score = scores[u];
-        //     scores[u] = base_score + kDamp * incoming_total;
-            
-        //     error += fabs(scores[u] - old_score);
-        //     // outgoing_contrib[u] = scores[u] / g.GetDegreeOut(u);
-        //     outgoing_contrib[u] = scores[u] / degree_cache[u];
-        // }
-
-        #pragma omp parallel for reduction(+ : error) schedule(dynamic, 1)
-        for (NodeID u1 = 0; u1 < v_count; u1 += VBATCH) {
-            NodeID u2 = std::min(u1 + VBATCH, v_count);
-            auto incoming_total = std::make_unique<ScoreT[]>(u2 - u1);
-            memset(incoming_total.get(), 0, sizeof(ScoreT) * (u2 - u1));
+        double error = PullGSIteration(g, scores.get(), outgoing_contrib.get(), [&](NodeID u) {
+            return degree_cache[u];
+        }, base_score);
 
-            g.IterateNeighborsInRange(u1, u2, [&](NodeID u, NodeID v) {
-                incoming_total[u - u1] += outgoing_contrib[v];
-            });
+        if (error < epsilon)
+            break;
+        if (logging_enabled)
+            fmt::println("PR Iteration {} (error={:.9f}, time={:.2f}s)", iter, error, t.Stop());
+    }
+    return scores.release();
+}
 
-            for(NodeID u = u1; u < u2; u++) {
-                ScoreT old_score = scores[u];
-                scores[u] = base_score + kDamp * incoming_total[u - u1];
-                error += fabs(scores[u] - old_score);
-                // outgoing_contrib[u] = scores[u] / g.GetDegreeOut(u);
-                outgoing_contrib[u] = scores[u] / degree_cache[u];
-            }
-        }
+// PageRankPullGS with outgoing_contrib in bfloat16 and degree_cache as 16 bit codes, which halves
+// the random reads of the inner loop (sums stay in float). The last refine_iters iterations use
+// float contributions from exact degrees and shrink the error left by bfloat16 rounding.
+template <typename TGraph>
+    requires dcsr::BasicIterableTwoWayGraph<TGraph>
+ScoreT* PageRankPullGSReduced(const TGraph &g, int max_iters, double epsilon=0, bool logging_enabled = false, int refine_iters = 1) {
+    using NodeID = typename TGraph::VertexType;
+    const size_t v_count = g.VertexCount();
+    const ScoreT init_score = 1.0f / v_count;
+    const ScoreT base_score = (1.0f - kDamp) / v_count;
+    refine_iters = std::min(refine_iters, max_iters);
+
+    auto scores = std::make_unique<ScoreT[]>(v_count);
+    auto outgoing_contrib = std::make_unique<dcsr::BFloat16[]>(v_count);
+    auto degree_code = std::make_unique<uint16_t[]>(v_count);
+    #pragma omp parallel for
+    for (NodeID n=0; n < v_count; n++) {
+        scores[n] = init_score;
+        degree_code[n] = dcsr::EncodeDegree16(g.GetDegreeOut(n));
+        outgoing_contrib[n] = init_score / dcsr::DecodeDegree16(degree_code[n]);
+    }
+
+    int iter = 0;
+    for (; iter < max_iters - refine_iters; iter++) {
+        SimpleTimer t;
+        double error = PullGSIteration(g, scores.get(), outgoing_contrib.get(), [&](NodeID u) {
+            return dcsr::DecodeDegree16(degree_code[u]);
+        }, base_score);
+
+        if (error < epsilon)
+            break;
+        if (logging_enabled)
+            fmt::println("PR Iteration {} (bf16, error={:.9f}, time={:.2f}s)", iter, error, t.Stop());
+    }
+    outgoing_contrib.reset();
+    degree_code.reset();
+
+    // Refinement in float
+    auto exact_contrib = std::make_unique<ScoreT[]>(v_count);
+    #pragma omp parallel for
+    for (NodeID n=0; n < v_count; n++) {
+        exact_contrib[n] = scores[n] / g.GetDegreeOut(n);
+    }
+    for (int r = 0; r < refine_iters; r++, iter++) {
+        SimpleTimer t;
+        double error = PullGSIteration(g, scores.get(), exact_contrib.get(), [&](NodeID u) {
+            return g.GetDegreeOut(u);
+        }, base_score);
+        if (logging_enabled)
+            fmt::println("PR Iteration {} (fp32, error={:.9f}, time={:.2f}s)", iter, error, t.Stop());
+    }
+    return scores.release();
+}
+
+
+// Same scores as PageRankPullGS without Gauss-Seidel (Jacobi), but contributions are pushed along
+// out edges through propagation blocking, so reads of outgoing_contrib are sequential and sums
+// stay in cache segments (see dcsr::PropagationBins)
+template <typename TGraph>
+    requires dcsr::BasicIterableTwoWayGraph<TGraph>
+ScoreT* PageRankPushPB(const TGraph &g, int max_iters, double epsilon=0, bool logging_enabled = false) {
+    using NodeID = typename TGraph::VertexType;
+    const size_t v_count = g.VertexCount();
+    const ScoreT init_score = 1.0f / v_count;
+    const ScoreT base_score = (1.0f - kDamp) / v_count;
+
+    auto scores = std::make_unique<ScoreT[]>(v_count);
+    auto outgoing_contrib = std::make_unique<ScoreT[]>(v_count);
+    auto degree_cache = std::make_unique<uint32_t[]>(v_count);
+    #pragma omp parallel for
+    for (NodeID n=0; n < v_count; n++) {
+        scores[n] = init_score;
+        degree_cache[n] = g.GetDegreeOut(n);
+        outgoing_contrib[n] = init_score / degree_cache[n];
+    }
+
+    dcsr::PropagationBins<NodeID, ScoreT> bins(v_count);
+    for (int iter=0; iter < max_iters; iter++) {
+        SimpleTimer t;
+        bins.Scatter([&](NodeID u, const auto& emit) {
+            g.IterateNeighborsOut(u, emit);
+        }, [&](NodeID u) {
+            return outgoing_contrib[u];
+        });
+
+        double error = bins.Gather([&](NodeID u, ScoreT incoming_total) {
+            ScoreT old_score = scores[u];
+            scores[u] = base_score + kDamp * incoming_total;
+            outgoing_contrib[u] = scores[u] / degree_cache[u];
+            return fabs(scores[u] - old_score);
+        });
 
         if (error < epsilon)
             break;
@@ -106,6 +230,20 @@ auto pr_gapbs(const TGraph *g, int max_iters) {
     return std::unique_ptr<ScoreT[]>(scores);
 }
 
+template <typename TGraph>
+    requires dcsr::BasicIterableTwoWayGraph<TGraph>
+auto pr_gapbs_reduced(const TGraph *g, int max_iters) {
+    auto scores = PageRankPullGSReduced(*g, max_iters, 0, true);
+    return std::unique_ptr<ScoreT[]>(scores);
+}
+
+template <typename TGraph>
+    requires dcsr::BasicIterableTwoWayGraph<TGraph>
+auto pr_gapbs_pb(const TGraph *g, int max_iters) {
+    auto scores = PageRankPushPB(*g, max_iters, 0, true);
+    return std::unique_ptr<ScoreT[]>(scores);
+}
+
 template<typename T=float>
 void PrintScores(T* scores, int64_t N) {
     T max_score = 0;
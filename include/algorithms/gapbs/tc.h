@@ -278,6 +278,26 @@ size_t OrderedCountPrepared(const UGraph &g) {
     return total;
 }
 
+// Count triangles u > v > w on storage directly, common neighbors of u and v are found by
+// intersecting their neighbor blocks (UGraph::CountCommonNeighbors), no copy of the graph
+template <class UGraph>
+    requires dcsr::UndirectedGraph<UGraph>
+size_t OrderedCountIntersect(const UGraph &g) {
+    using NodeID = typename UGraph::VertexType;
+    size_t num_nodes = g.GraphView().VertexCount();
+    size_t total = 0;
+
+    #pragma omp parallel for reduction(+ : total) schedule(dynamic, 64)
+    for (NodeID u=0; u < num_nodes; u++) {
+        g.GraphView().IterateNeighbors(u, [&](NodeID v) {
+            if (v < u) {
+                total += g.CountCommonNeighbors(u, v, v);
+            }
+        });
+    }
+    return total;
+}
+
 // Uses heuristic to see if worth relabeling
 template <typename UGraph>
     requires dcsr::UndirectedGraph<UGraph>
@@ -298,3 +318,10 @@ size_t tc_gapbs_cached(const UGraph *g) {
     size_t triangles_count = OrderedCountPrepared(*g);
     return triangles_count;
 }
+
+template <typename UGraph>
+    requires dcsr::UndirectedGraph<UGraph>
+size_t tc_gapbs_intersect(const UGraph *g) {
+    size_t triangles_count = OrderedCountIntersect(*g);
+    return triangles_count;
+}
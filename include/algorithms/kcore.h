@@ -0,0 +1,218 @@
+#ifndef __DCSR_KCORE_H__
+#define __DCSR_KCORE_H__
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include "concepts.h"
+#include "algorithms/ligra.h"
+
+namespace dcsr {
+
+// Neighbors of v ignoring direction: UGraph stores both directions, TGraph is iterated both ways
+template<typename GraphType, typename Func>
+void IterateUndirectedNeighbors(const GraphType* graph, typename GraphType::VertexType v, const Func& func) {
+    if constexpr (UndirectedGraph<GraphType>) {
+        graph->GraphView().IterateNeighbors(v, func);
+    } else {
+        graph->IterateNeighborsOut(v, func);
+        graph->IterateNeighborsIn(v, func);
+    }
+}
+
+template<typename GraphType>
+size_t UndirectedVertexCount(const GraphType* graph) {
+    if constexpr (UndirectedGraph<GraphType>) {
+        return graph->GraphView().VertexCount();
+    } else {
+        return graph->VertexCount();
+    }
+}
+
+template<typename GraphType>
+size_t UndirectedDegree(const GraphType* graph, typename GraphType::VertexType v) {
+    if constexpr (UndirectedGraph<GraphType>) {
+        return graph->GraphView().GetDegree(v);
+    } else {
+        return graph->GetDegreeOut(v) + graph->GetDegreeIn(v);
+    }
+}
+
+/**
+ * @brief Core number of every vertex by bucketed peeling (Julienne). Vertices sit in buckets of
+ * their current degree, only OPEN_BUCKETS levels are materialized, higher degrees wait in an
+ * overflow bucket which is redistributed when the window is used up. Level k extracts its bucket
+ * in parallel, then peels rounds: removed vertices decrement degrees of live neighbors atomically,
+ * the thread which brings a degree down to k puts the neighbor in next round, others move it to
+ * the bucket of its new degree (lazily, stale entries are filtered on extraction).
+ * Directed graphs are treated as undirected (degree = in + out).
+ */
+template<typename GraphType>
+    requires (UndirectedGraph<GraphType> || BasicIterableTwoWayGraph<GraphType>)
+std::unique_ptr<uint32_t[]> kcore(const GraphType* graph) {
+    using VID = typename GraphType::VertexType;
+    constexpr size_t OPEN_BUCKETS = 128;
+    constexpr uint32_t REMOVED = std::numeric_limits<uint32_t>::max();
+
+    size_t v_count = UndirectedVertexCount(graph);
+    size_t threads = omp_get_max_threads();
+    auto degree = std::make_unique_for_overwrite<uint32_t[]>(v_count);
+    auto core = std::make_unique_for_overwrite<uint32_t[]>(v_count);     // REMOVED while alive
+
+    #pragma omp parallel for schedule(dynamic, 16384)
+    for(size_t v = 0; v < v_count; v++) {
+        degree[v] = UndirectedDegree(graph, v);
+        core[v] = REMOVED;
+    }
+
+    std::vector<std::vector<VID>> buckets(OPEN_BUCKETS);
+    std::vector<VID> overflow(v_count);
+    #pragma omp parallel for schedule(static)
+    for(size_t v = 0; v < v_count; v++) {
+        overflow[v] = v;
+    }
+
+    // Move overflow vertices with degree < base + OPEN_BUCKETS into buckets, base is the min degree
+    auto open_window = [&]() -> size_t {
+        uint32_t base = REMOVED;
+        #pragma omp parallel for reduction(min:base)
+        for(size_t i = 0; i < overflow.size(); i++) {
+            if(core[overflow[i]] == REMOVED) {
+                base = std::min(base, degree[overflow[i]]);
+            }
+        }
+        std::vector<std::vector<std::pair<VID, uint32_t>>> locals(threads);
+        std::vector<std::vector<VID>> rest(threads);
+        #pragma omp parallel
+        {
+            auto& local = locals[omp_get_thread_num()];
+            auto& keep = rest[omp_get_thread_num()];
+            #pragma omp for schedule(static)
+            for(size_t i = 0; i < overflow.size(); i++) {
+                VID v = overflow[i];
+                if(core[v] != REMOVED) {
+                    continue;
+                }
+                if(degree[v] - base < OPEN_BUCKETS) {
+                    local.emplace_back(v, degree[v] - base);
+                } else {
+                    keep.push_back(v);
+                }
+            }
+        }
+        overflow = VertexSubset<VID>::Concat(rest);
+        for(auto& local: locals) {
+            for(auto [v, b]: local) {
+                buckets[b].push_back(v);
+            }
+        }
+        return base;
+    };
+
+    std::vector<std::vector<VID>> locals(threads);
+    std::vector<std::vector<std::pair<VID, uint32_t>>> moves(threads);
+    std::vector<size_t> histogram(threads * OPEN_BUCKETS);
+
+    size_t base = 0;
+    size_t cur = 0;     // bucket index in window
+    if(!overflow.empty()) {
+        base = open_window();
+    }
+    while(true) {
+        while(cur < OPEN_BUCKETS && buckets[cur].empty()) {
+            cur++;
+        }
+        if(cur == OPEN_BUCKETS) {
+            if(overflow.empty()) {
+                break;
+            }
+            base = open_window();
+            cur = 0;
+            continue;
+        }
+        uint32_t k = base + cur;
+
+        // Extract live vertices whose degree is still k
+        auto& bucket = buckets[cur];
+        #pragma omp parallel
+        {
+            auto& local = locals[omp_get_thread_num()];
+            local.clear();
+            #pragma omp for schedule(static)
+            for(size_t i = 0; i < bucket.size(); i++) {
+                VID v = bucket[i];
+                if(core[v] == REMOVED && degree[v] == k) {
+                    local.push_back(v);
+                }
+            }
+        }
+        std::vector<VID> frontier = VertexSubset<VID>::Concat(locals);
+        bucket.clear();
+        bucket.shrink_to_fit();
+
+        while(!frontier.empty()) {
+            #pragma omp parallel for schedule(static)
+            for(size_t i = 0; i < frontier.size(); i++) {
+                core[frontier[i]] = k;
+            }
+
+            std::fill(histogram.begin(), histogram.end(), 0);
+            #pragma omp parallel
+            {
+                size_t tid = omp_get_thread_num();
+                auto& local = locals[tid];
+                auto& local_moves = moves[tid];
+                size_t* hist = histogram.data() + tid * OPEN_BUCKETS;
+                local.clear();
+                local_moves.clear();
+                #pragma omp for schedule(dynamic, 64)
+                for(size_t i = 0; i < frontier.size(); i++) {
+                    IterateUndirectedNeighbors(graph, frontier[i], [&](VID w) {
+                        if(core[w] != REMOVED) {
+                            return;
+                        }
+                        uint32_t d = std::atomic_ref<uint32_t>(degree[w]).fetch_sub(1, std::memory_order_relaxed) - 1;
+                        if(d == k) {
+                            local.push_back(w);
+                        } else if(d > k && d - base < OPEN_BUCKETS) {
+                            local_moves.emplace_back(w, d - base);
+                            hist[d - base]++;
+                        }
+                    });
+                }
+            }
+
+            // Scatter moves into buckets, offsets from per-thread histograms
+            for(size_t b = cur + 1; b < OPEN_BUCKETS; b++) {
+                size_t total = buckets[b].size();
+                for(size_t t = 0; t < threads; t++) {
+                    size_t c = histogram[t * OPEN_BUCKETS + b];
+                    histogram[t * OPEN_BUCKETS + b] = total;
+                    total += c;
+                }
+                buckets[b].resize(total);
+            }
+            #pragma omp parallel
+            {
+                size_t tid = omp_get_thread_num();
+                size_t* offset = histogram.data() + tid * OPEN_BUCKETS;
+                for(auto [w, b]: moves[tid]) {
+                    buckets[b][offset[b]++] = w;
+                }
+            }
+
+            frontier = VertexSubset<VID>::Concat(locals);
+        }
+        cur++;
+    }
+    return core;
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_KCORE_H__
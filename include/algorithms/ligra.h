@@ -0,0 +1,265 @@
+#ifndef __DCSR_LIGRA_H__
+#define __DCSR_LIGRA_H__
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <omp.h>
+#include "common.h"
+#include "concepts.h"
+
+namespace dcsr {
+
+/**
+ * @brief Ligra style frontier, a sparse vertex list or a dense flag array, converted on demand
+ * by EdgeMap (push wants sparse, pull wants dense).
+ */
+template<typename VID>
+class VertexSubset {
+private:
+    size_t n_;
+    size_t size_;
+    bool dense_;
+    std::vector<VID> sparse_;
+    std::vector<uint8_t> flags_;
+
+public:
+    explicit VertexSubset(size_t n): n_(n), size_(0), dense_(false) {}
+
+    VertexSubset(size_t n, VID v): n_(n), size_(1), dense_(false), sparse_{v} {}
+
+    VertexSubset(size_t n, std::vector<VID>&& vertices)
+    : n_(n), size_(vertices.size()), dense_(false), sparse_(std::move(vertices)) {}
+
+    // flags[v] != 0 for vertices in subset, size is the number of them
+    VertexSubset(size_t n, std::vector<uint8_t>&& flags, size_t size)
+    : n_(n), size_(size), dense_(true), flags_(std::move(flags)) {}
+
+    size_t VertexCount() const {
+        return n_;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    bool IsDense() const {
+        return dense_;
+    }
+
+    // Only for dense subset
+    bool Contains(VID v) const {
+        return flags_[v] != 0;
+    }
+
+    // Only for sparse subset
+    std::span<const VID> Vertices() const {
+        return sparse_;
+    }
+
+    void ToDense() {
+        if(dense_) {
+            return;
+        }
+        flags_.assign(n_, 0);
+        #pragma omp parallel for
+        for(size_t i = 0; i < sparse_.size(); i++) {
+            flags_[sparse_[i]] = 1;
+        }
+        sparse_ = {};
+        dense_ = true;
+    }
+
+    void ToSparse() {
+        if(!dense_) {
+            return;
+        }
+        std::vector<std::vector<VID>> locals(omp_get_max_threads());
+        #pragma omp parallel
+        {
+            auto& local = locals[omp_get_thread_num()];
+            #pragma omp for schedule(static)
+            for(size_t v = 0; v < n_; v++) {
+                if(flags_[v]) {
+                    local.push_back(v);
+                }
+            }
+        }
+        sparse_ = Concat(locals);
+        flags_ = {};
+        dense_ = false;
+    }
+
+    // Call f(v) for each vertex in subset in parallel
+    template<typename Func>
+    void ForEach(const Func& f) const {
+        if(dense_) {
+            #pragma omp parallel for schedule(dynamic, 1024)
+            for(size_t v = 0; v < n_; v++) {
+                if(flags_[v]) {
+                    f(static_cast<VID>(v));
+                }
+            }
+        } else {
+            #pragma omp parallel for schedule(dynamic, 1024)
+            for(size_t i = 0; i < sparse_.size(); i++) {
+                f(sparse_[i]);
+            }
+        }
+    }
+
+    // Concatenate per-thread vertex lists
+    static std::vector<VID> Concat(const std::vector<std::vector<VID>>& locals) {
+        std::vector<size_t> offset(locals.size() + 1, 0);
+        for(size_t t = 0; t < locals.size(); t++) {
+            offset[t + 1] = offset[t] + locals[t].size();
+        }
+        std::vector<VID> all(offset.back());
+        #pragma omp parallel for
+        for(size_t t = 0; t < locals.size(); t++) {
+            std::copy(locals[t].begin(), locals[t].end(), all.begin() + offset[t]);
+        }
+        return all;
+    }
+};
+
+enum class EdgeMapDirection {
+    Auto,
+    Push,   // sparse, IterateNeighborsOut from frontier
+    Pull,   // dense, IterateNeighborsIn of every vertex
+};
+
+/**
+ * @brief Ligra EdgeMap over edges (s, d) with s in frontier, returns vertices d which are updated.
+ * F provides:
+ *   bool Cond(VID d)                   whether d still needs updates
+ *   bool Update(VID s, VID d)          pull, d is only updated by current thread
+ *   bool UpdateAtomic(VID s, VID d)    push, concurrent on d, should be true at most once per d
+ * Auto picks pull if frontier size plus its out degrees is more than EdgeCount() / 20.
+ */
+template<ConditionalStopIterableTwoWayGraph GraphType, typename F>
+VertexSubset<typename GraphType::VertexType> EdgeMap(const GraphType* graph, VertexSubset<typename GraphType::VertexType>& frontier,
+                                                     F& f, EdgeMapDirection direction = EdgeMapDirection::Auto) {
+    using VID = typename GraphType::VertexType;
+    size_t n = graph->VertexCount();
+
+    if(direction == EdgeMapDirection::Auto) {
+        // Dense frontier is summed over its flags, so a pull level does not convert it back and forth
+        size_t out_degrees = 0;
+        if(frontier.IsDense()) {
+            #pragma omp parallel for reduction(+:out_degrees) schedule(static)
+            for(size_t v = 0; v < n; v++) {
+                if(frontier.Contains(v)) {
+                    out_degrees += graph->GetDegreeOut(v);
+                }
+            }
+        } else {
+            auto vertices = frontier.Vertices();
+            #pragma omp parallel for reduction(+:out_degrees)
+            for(size_t i = 0; i < vertices.size(); i++) {
+                out_degrees += graph->GetDegreeOut(vertices[i]);
+            }
+        }
+        bool dense = (frontier.Size() + out_degrees) > graph->EdgeCount() / 20;
+        direction = dense ? EdgeMapDirection::Pull : EdgeMapDirection::Push;
+    }
+
+    if(direction == EdgeMapDirection::Push) {
+        frontier.ToSparse();
+        auto vertices = frontier.Vertices();
+        std::vector<std::vector<VID>> locals(omp_get_max_threads());
+        #pragma omp parallel
+        {
+            auto& local = locals[omp_get_thread_num()];
+            #pragma omp for schedule(dynamic, 64)
+            for(size_t i = 0; i < vertices.size(); i++) {
+                VID s = vertices[i];
+                graph->IterateNeighborsOut(s, [&](VID d) {
+                    if(f.Cond(d) && f.UpdateAtomic(s, d)) {
+                        local.push_back(d);
+                    }
+                });
+            }
+        }
+        return VertexSubset<VID>(n, VertexSubset<VID>::Concat(locals));
+    }
+
+    frontier.ToDense();
+    std::vector<uint8_t> next(n, 0);
+    size_t count = 0;
+    #pragma omp parallel for reduction(+:count) schedule(dynamic, 1024)
+    for(size_t v = 0; v < n; v++) {
+        VID d = v;
+        if(!f.Cond(d)) {
+            continue;
+        }
+        graph->IterateNeighborsIn(d, [&](VID s) {
+            if(frontier.Contains(s) && f.Update(s, d) && !next[d]) {
+                next[d] = 1;
+                count++;
+            }
+            return f.Cond(d);
+        });
+    }
+    return VertexSubset<VID>(n, std::move(next), count);
+}
+
+template<typename VID, typename Func>
+void VertexMap(const VertexSubset<VID>& subset, const Func& f) {
+    subset.ForEach(f);
+}
+
+// Vertices of subset with f(v) == true
+template<typename VID, typename Func>
+VertexSubset<VID> VertexFilter(const VertexSubset<VID>& subset, const Func& f) {
+    std::vector<std::vector<VID>> locals(omp_get_max_threads());
+    subset.ForEach([&](VID v) {
+        if(f(v)) {
+            locals[omp_get_thread_num()].push_back(v);
+        }
+    });
+    return VertexSubset<VID>(subset.VertexCount(), VertexSubset<VID>::Concat(locals));
+}
+
+/**
+ * @brief BFS on EdgeMap, an example of using the framework, returns parent of each vertex
+ * (-1 for unreachable, root is parent of itself).
+ */
+template<ConditionalStopIterableTwoWayGraph GraphType>
+std::vector<int64_t> bfs_ligra(const GraphType* graph, typename GraphType::VertexType root) {
+    using VID = typename GraphType::VertexType;
+    size_t n = graph->VertexCount();
+    std::vector<int64_t> parents(n, -1);
+    parents[root] = root;
+
+    struct BFSFunc {
+        std::vector<int64_t>& parents;
+
+        bool Cond(VID d) const {
+            return parents[d] == -1;
+        }
+        bool Update(VID s, VID d) {
+            parents[d] = s;
+            return true;
+        }
+        bool UpdateAtomic(VID s, VID d) {
+            int64_t expected = -1;
+            return std::atomic_ref<int64_t>(parents[d]).compare_exchange_strong(expected, s);
+        }
+    } f{parents};
+
+    VertexSubset<VID> frontier(n, root);
+    while(!frontier.Empty()) {
+        frontier = EdgeMap(graph, frontier, f);
+    }
+    return parents;
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_LIGRA_H__
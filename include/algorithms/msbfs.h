@@ -0,0 +1,199 @@
+#ifndef __DCSR_MSBFS_H__
+#define __DCSR_MSBFS_H__
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+#include <omp.h>
+#include "common.h"
+#include "concepts.h"
+
+namespace dcsr {
+
+/**
+ * @brief Sources of a multi-source BFS, W words of 64 bits, bit i of word i / 64 is source i.
+ * Word operations are plain loops, for W = 8 the compiler turns them into 512 bits vector ops.
+ */
+template<size_t W>
+struct alignas(std::min<size_t>(W * sizeof(uint64_t), 64)) SourceMask {
+    std::array<uint64_t, W> words{};
+
+    bool Any() const {
+        uint64_t r = 0;
+        for(size_t i = 0; i < W; i++) {
+            r |= words[i];
+        }
+        return r != 0;
+    }
+
+    bool operator==(const SourceMask& rhs) const = default;
+
+    SourceMask& operator|=(const SourceMask& rhs) {
+        for(size_t i = 0; i < W; i++) {
+            words[i] |= rhs.words[i];
+        }
+        return *this;
+    }
+
+    // this & ~rhs
+    SourceMask AndNot(const SourceMask& rhs) const {
+        SourceMask r;
+        for(size_t i = 0; i < W; i++) {
+            r.words[i] = words[i] & ~rhs.words[i];
+        }
+        return r;
+    }
+
+    // Concurrent |= by several threads (push step)
+    void AtomicOr(const SourceMask& rhs) {
+        for(size_t i = 0; i < W; i++) {
+            if(rhs.words[i] != 0) {
+                std::atomic_ref<uint64_t>(words[i]).fetch_or(rhs.words[i], std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Set(size_t i) {
+        words[i / 64] |= 1ull << (i % 64);
+    }
+
+    // Call f(i) for each source i in mask
+    template<typename Func>
+    void ForEach(const Func& f) const {
+        for(size_t w = 0; w < W; w++) {
+            uint64_t bits = words[w];
+            while(bits) {
+                f(w * 64 + std::countr_zero(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Bit-parallel BFS from up to 64 * W roots at once (MS-BFS), one traversal of the graph
+ * serves all roots. func(v, level, mask) is called in parallel once per vertex and level where
+ * v is first reached by the sources in mask (roots at level 0). Each level pushes masks along
+ * IterateNeighborsOut from the frontier, or pulls masks along IterateNeighborsIn of unfinished
+ * vertices when the frontier has more than EdgeCount() / 20 out edges.
+ */
+template<size_t W, ConditionalStopIterableTwoWayGraph GraphType, typename Func>
+void MultiSourceBFS(const GraphType* graph, std::span<const typename GraphType::VertexType> roots, const Func& func) {
+    using VID = typename GraphType::VertexType;
+    using Mask = SourceMask<W>;
+    dcsr_assert(roots.size() <= 64 * W, "Too many roots for MultiSourceBFS");
+
+    size_t v_count = graph->VertexCount();
+    auto seen = std::make_unique<Mask[]>(v_count);
+    auto visit = std::make_unique<Mask[]>(v_count);
+    auto visit_next = std::make_unique<Mask[]>(v_count);
+
+    Mask all;
+    for(size_t i = 0; i < roots.size(); i++) {
+        all.Set(i);
+        seen[roots[i]].Set(i);
+        visit[roots[i]].Set(i);
+    }
+
+    size_t frontier_degree = 0;
+    for(size_t i = 0; i < roots.size(); i++) {
+        // Sources of the same root share one callback
+        if(std::find(roots.begin(), roots.begin() + i, roots[i]) == roots.begin() + i) {
+            func(roots[i], size_t(0), seen[roots[i]]);
+            frontier_degree += graph->GetDegreeOut(roots[i]);
+        }
+    }
+
+    for(size_t level = 1; frontier_degree != 0; level++) {
+        if(frontier_degree > graph->EdgeCount() / 20) {
+            #pragma omp parallel for schedule(dynamic, 1024)
+            for(size_t v = 0; v < v_count; v++) {
+                if(seen[v] == all) {
+                    continue;
+                }
+                Mask next;
+                graph->IterateNeighborsIn(v, [&](VID from) {
+                    next |= visit[from];
+                    Mask reached = next;
+                    reached |= seen[v];
+                    return !(reached == all);
+                });
+                visit_next[v] = next.AndNot(seen[v]);
+            }
+        } else {
+            #pragma omp parallel for schedule(dynamic, 1024)
+            for(size_t v = 0; v < v_count; v++) {
+                if(!visit[v].Any()) {
+                    continue;
+                }
+                graph->IterateNeighborsOut(v, [&](VID to) {
+                    Mask d = visit[v].AndNot(seen[to]);
+                    if(d.Any()) {
+                        visit_next[to].AtomicOr(d);
+                    }
+                });
+            }
+        }
+
+        frontier_degree = 0;
+        #pragma omp parallel for reduction(+:frontier_degree) schedule(dynamic, 4096)
+        for(size_t v = 0; v < v_count; v++) {
+            Mask next = visit_next[v].AndNot(seen[v]);
+            visit[v] = next;
+            visit_next[v] = Mask();
+            if(next.Any()) {
+                seen[v] |= next;
+                frontier_degree += graph->GetDegreeOut(v);
+                func(static_cast<VID>(v), level, next);
+            }
+        }
+    }
+}
+
+// Per root results of msbfs, for closeness centrality and eccentricity (diameter bounds)
+struct MultiSourceBFSStats {
+    std::vector<uint64_t> reached;          // vertices reached, including the root
+    std::vector<uint64_t> distance_sum;     // sum of distances to reached vertices
+    std::vector<uint32_t> eccentricity;     // distance to the farthest reached vertex
+};
+
+template<size_t W, ConditionalStopIterableTwoWayGraph GraphType>
+MultiSourceBFSStats msbfs(const GraphType* graph, std::span<const typename GraphType::VertexType> roots) {
+    using VID = typename GraphType::VertexType;
+    size_t s = roots.size();
+    size_t threads = omp_get_max_threads();
+    std::vector<MultiSourceBFSStats> locals(threads);
+    for(auto& l: locals) {
+        l.reached.assign(s, 0);
+        l.distance_sum.assign(s, 0);
+        l.eccentricity.assign(s, 0);
+    }
+
+    MultiSourceBFS<W>(graph, roots, [&](VID, size_t level, const SourceMask<W>& mask) {
+        auto& l = locals[omp_get_thread_num()];
+        mask.ForEach([&](size_t i) {
+            l.reached[i]++;
+            l.distance_sum[i] += level;
+            l.eccentricity[i] = std::max<uint32_t>(l.eccentricity[i], level);
+        });
+    });
+
+    MultiSourceBFSStats stats = std::move(locals[0]);
+    for(size_t t = 1; t < threads; t++) {
+        for(size_t i = 0; i < s; i++) {
+            stats.reached[i] += locals[t].reached[i];
+            stats.distance_sum[i] += locals[t].distance_sum[i];
+            stats.eccentricity[i] = std::max(stats.eccentricity[i], locals[t].eccentricity[i]);
+        }
+    }
+    return stats;
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_MSBFS_H__
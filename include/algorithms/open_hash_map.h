@@ -0,0 +1,105 @@
+#ifndef __DCSR_OPEN_HASH_MAP_H__
+#define __DCSR_OPEN_HASH_MAP_H__
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace dcsr {
+
+/**
+ * @brief Small open addressing (linear probing) map from integer keys to accumulated values,
+ * for per-thread neighborhood aggregation. Occupied slots are listed, so ForEach and Clear cost
+ * the number of keys, not the capacity. Key max() is reserved as empty.
+ */
+template<typename K, typename V>
+class OpenHashMap {
+private:
+    static constexpr K EMPTY = std::numeric_limits<K>::max();
+
+    std::vector<K> keys_;
+    std::vector<V> values_;
+    std::vector<uint32_t> used_;     // occupied slots in insertion order
+    size_t shift_;
+
+    size_t Slot(K key) const {
+        return (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> shift_;
+    }
+
+    void Rehash(size_t capacity) {
+        std::vector<K> keys(capacity, EMPTY);
+        std::vector<V> values(capacity);
+        shift_ = 64 - std::countr_zero(capacity);
+        for(auto& s: used_) {
+            size_t i = Slot(keys_[s]);
+            while(keys[i] != EMPTY) {
+                i = (i + 1) & (capacity - 1);
+            }
+            keys[i] = keys_[s];
+            values[i] = values_[s];
+            s = i;
+        }
+        keys_ = std::move(keys);
+        values_ = std::move(values);
+    }
+
+public:
+    explicit OpenHashMap(size_t capacity = 64)
+    : keys_(std::bit_ceil(std::max<size_t>(capacity, 2)), EMPTY),
+      values_(keys_.size()),
+      shift_(64 - std::countr_zero(keys_.size())) {}
+
+    size_t size() const {
+        return used_.size();
+    }
+
+    // Value of key, inserted as V{} if missing
+    V& operator[](K key) {
+        if(2 * (used_.size() + 1) > keys_.size()) {
+            Rehash(keys_.size() * 2);
+        }
+        size_t mask = keys_.size() - 1;
+        size_t i = Slot(key);
+        while(keys_[i] != key) {
+            if(keys_[i] == EMPTY) {
+                keys_[i] = key;
+                values_[i] = V{};
+                used_.push_back(i);
+                break;
+            }
+            i = (i + 1) & mask;
+        }
+        return values_[i];
+    }
+
+    // Value of key, V{} if missing
+    V Get(K key) const {
+        size_t mask = keys_.size() - 1;
+        for(size_t i = Slot(key); keys_[i] != EMPTY; i = (i + 1) & mask) {
+            if(keys_[i] == key) {
+                return values_[i];
+            }
+        }
+        return V{};
+    }
+
+    // Call f(key, value) for each key in insertion order
+    template<typename Func>
+    void ForEach(const Func& f) const {
+        for(auto s: used_) {
+            f(keys_[s], values_[s]);
+        }
+    }
+
+    void Clear() {
+        for(auto s: used_) {
+            keys_[s] = EMPTY;
+        }
+        used_.clear();
+    }
+};
+
+} // namespace dcsr
+
+#endif // __DCSR_OPEN_HASH_MAP_H__
@@ -0,0 +1,157 @@
+#ifndef __DCSR_PPR_H__
+#define __DCSR_PPR_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+#include "concepts.h"
+#include "algorithms/open_hash_map.h"
+
+namespace dcsr {
+
+/**
+ * @brief Per-query state of forward push PPR: residual, estimate and cached out degree of every
+ * vertex the query touched, in one open addressing map, plus frontier buffers. Keep one arena per
+ * thread and reuse it across queries, so a query only allocates when it touches more vertices
+ * than any earlier one.
+ */
+template<typename VID>
+class PPRArena {
+public:
+    struct VertexState {
+        double residual;
+        double estimate;
+        uint32_t degree;    // out degree + 1, 0 when unknown
+        uint32_t round;     // last round it was queued for
+    };
+
+private:
+    OpenHashMap<VID, VertexState> states_;
+    std::vector<VID> frontier_, next_, targets_;
+    std::vector<double> pushed_;
+    std::vector<uint32_t> counts_;
+
+public:
+    explicit PPRArena(size_t capacity = 4096): states_(capacity) {}
+
+    // Vertices touched by last query
+    size_t TouchedCount() const {
+        return states_.size();
+    }
+
+    // Call f(v, score) for each vertex with a nonzero estimate in last query
+    template<typename Func>
+    void ForEachEstimate(const Func& f) const {
+        states_.ForEach([&](VID v, const VertexState& s) {
+            if(s.estimate != 0) {
+                f(v, s.estimate);
+            }
+        });
+    }
+
+    /**
+     * @brief Personalized PageRank of source by forward push (Andersen, Chung, Lang). Starting from
+     * residual 1 at source, every vertex u with residual r(u) >= epsilon * deg(u) keeps alpha * r(u)
+     * as estimate and spreads the rest evenly over its out edges (dangling vertices give it back to
+     * source). Each round pushes the whole frontier through IterateNeighborsOutBatch, so neighbor
+     * lookups of frontier vertices overlap. Cost is O(1 / (alpha * epsilon)) edge pushes independent
+     * of graph size; estimates underestimate scores by at most the residuals left (each below
+     * epsilon * deg).
+     * Single threaded, queries read the graph only: run concurrent queries with one arena each,
+     * between WaitSortingAndPrepareAnalysis and FinishAlgorithm. Returns the number of pushes.
+     */
+    template<BatchIterableTwoWayGraph GraphType>
+    size_t ForwardPush(const GraphType* graph, VID source, double alpha, double epsilon) {
+        states_.Clear();
+        states_[source] = VertexState{1.0, 0.0, 0, 0};
+        frontier_.assign(1, source);
+
+        // Queue v for round if its residual reached the threshold
+        auto queue = [&](VID v, uint32_t round) {
+            VertexState& s = states_[v];
+            if(s.round == round) {
+                return;
+            }
+            if(s.degree == 0) {
+                s.degree = graph->GetDegreeOut(v) + 1;
+            }
+            if(s.residual >= epsilon * std::max<uint32_t>(s.degree - 1, 1)) {
+                s.round = round;
+                next_.push_back(v);
+            }
+        };
+
+        size_t pushes = 0;
+        for(uint32_t round = 1; !frontier_.empty(); round++) {
+            pushed_.resize(frontier_.size());
+            for(size_t i = 0; i < frontier_.size(); i++) {
+                VertexState& s = states_[frontier_[i]];
+                pushed_[i] = s.residual;
+                s.residual = 0;
+                s.estimate += alpha * pushed_[i];
+            }
+
+            targets_.clear();
+            counts_.assign(frontier_.size(), 0);
+            size_t cursor = 0;
+            graph->IterateNeighborsOutBatch(std::span<const VID>(frontier_), [&](VID from, VID to) {
+                while(frontier_[cursor] != from) {
+                    cursor++;
+                }
+                counts_[cursor]++;
+                targets_.push_back(to);
+            });
+
+            next_.clear();
+            auto target = targets_.begin();
+            for(size_t i = 0; i < frontier_.size(); i++) {
+                double rest = (1 - alpha) * pushed_[i];
+                if(counts_[i] == 0) {
+                    states_[source].residual += rest;
+                    queue(source, round);
+                    continue;
+                }
+                states_[frontier_[i]].degree = counts_[i] + 1;
+                double share = rest / counts_[i];
+                for(uint32_t j = 0; j < counts_[i]; j++, target++) {
+                    states_[*target].residual += share;
+                    queue(*target, round);
+                }
+                pushes += counts_[i];
+            }
+            std::swap(frontier_, next_);
+        }
+        return pushes;
+    }
+};
+
+// Personalized PageRank of source by forward push into arena, see PPRArena::ForwardPush
+template<BatchIterableTwoWayGraph GraphType>
+size_t ppr_forward_push(const GraphType* graph, typename GraphType::VertexType source,
+                        PPRArena<typename GraphType::VertexType>& arena, double alpha = 0.15, double epsilon = 1e-6) {
+    return arena.ForwardPush(graph, source, alpha, epsilon);
+}
+
+// k vertices of largest PPR score for source, in decreasing order of score (source included)
+template<BatchIterableTwoWayGraph GraphType>
+std::vector<std::pair<typename GraphType::VertexType, double>> ppr_top_k(const GraphType* graph, typename GraphType::VertexType source, size_t k,
+                                                                      PPRArena<typename GraphType::VertexType>& arena, double alpha = 0.15, double epsilon = 1e-6) {
+    using VID = typename GraphType::VertexType;
+    ppr_forward_push(graph, source, arena, alpha, epsilon);
+    std::vector<std::pair<VID, double>> scores;
+    arena.ForEachEstimate([&](VID v, double score) {
+        scores.emplace_back(v, score);
+    });
+    k = std::min(k, scores.size());
+    std::partial_sort(scores.begin(), scores.begin() + k, scores.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    });
+    scores.resize(k);
+    return scores;
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_PPR_H__
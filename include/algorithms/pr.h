@@ -1,34 +1,104 @@
 #ifndef __DCSR_PR_H__
 #define __DCSR_PR_H__
 
+#include <algorithm>
+#include <bit>
+#include <vector>
+#include <omp.h>
+#include "common.h"
 #include "concepts.h"
+#include "env/base.h"
 
 namespace dcsr {
 
-// Credits to :
-// http://www.memoryhole.net/kyle/2012/06/a_use_for_volatile_in_multithr.html
-typedef float rank_t; 
-float qthread_dincr(float *operand, float incr)
-{
-    //*operand = *operand + incr;
-    //return incr;
-    
-    union {
-       rank_t   d;
-       uint32_t i;
-    } oldval, newval, retval;
-    do {
-         oldval.d = *(volatile rank_t *)operand;
-         newval.d = oldval.d + incr;
-         //__asm__ __volatile__ ("lock; cmpxchgq %1, (%2)"
-         __asm__ __volatile__ ("lock; cmpxchg %1, (%2)"
-                                : "=a" (retval.i)
-                                : "r" (newval.i), "r" (operand),
-                                 "0" (oldval.i)
-                                : "memory");
-    } while (retval.i != oldval.i);
-    return oldval.d;
-}
+/**
+ * @brief Propagation blocking: contributions sent along edges are binned by destination segment
+ * (per thread, no atomics), then each segment is summed by one thread. A segment is sized to stay
+ * in cache while summed, so both phases stream through memory instead of updating random
+ * vertices. Destinations are recorded by the first Scatter and reused, later ones only write
+ * values, so the graph and the thread count must not change between calls.
+ * Memory: a destination and a value per edge, (sizeof(VertexType) + sizeof(T)) bytes per edge
+ * (8 for VID32 and float) on top of the graph.
+ */
+template<typename VertexType, typename T>
+class PropagationBins {
+private:
+    size_t v_count_;
+    size_t threads_;
+    size_t shift_;          // log2 of segment width
+    size_t seg_count_;
+    bool built_;
+    std::vector<std::vector<std::vector<VertexType>>> dests_;   // [thread][segment]
+    std::vector<std::vector<std::vector<T>>> values_;
+
+public:
+    explicit PropagationBins(size_t v_count)
+    : v_count_(v_count), threads_(omp_get_max_threads()), built_(false) {
+        size_t width = std::min(L2_CACHE_SIZE, L3_CACHE_SIZE / threads_) / 2 / sizeof(T);
+        shift_ = std::countr_zero(std::bit_floor(std::max<size_t>(width, 1024)));
+        seg_count_ = (v_count_ + (1ull << shift_) - 1) >> shift_;
+        dests_.assign(threads_, std::vector<std::vector<VertexType>>(seg_count_));
+        values_.assign(threads_, std::vector<std::vector<T>>(seg_count_));
+    }
+
+    // neighbors(u, emit) calls emit(d) for each destination d of u, value(u) is sent to each
+    template<typename Neighbors, typename Value>
+    void Scatter(const Neighbors& neighbors, const Value& value) {
+        #pragma omp parallel num_threads(threads_)
+        {
+            // Recorded destinations are replayed by the same split of sources, a smaller team would misalign them
+            dcsr_assert(size_t(omp_get_num_threads()) == threads_, "PropagationBins needs a full team of threads");
+            auto& dests = dests_[omp_get_thread_num()];
+            auto& values = values_[omp_get_thread_num()];
+            std::vector<size_t> cursor(built_ ? seg_count_ : 0);
+            // Static schedule, each thread bins the same sources in every call
+            #pragma omp for schedule(static, 4096)
+            for(size_t u = 0; u < v_count_; u++) {
+                T x = value(static_cast<VertexType>(u));
+                if(built_) {
+                    neighbors(static_cast<VertexType>(u), [&](VertexType d) {
+                        size_t seg = d >> shift_;
+                        values[seg][cursor[seg]++] = x;
+                    });
+                } else {
+                    neighbors(static_cast<VertexType>(u), [&](VertexType d) {
+                        dests[d >> shift_].push_back(d);
+                        values[d >> shift_].push_back(x);
+                    });
+                }
+            }
+        }
+        built_ = true;
+    }
+
+    // f(v, sum) for each vertex with the sum of values sent to it, in parallel. Returns sum of f
+    template<typename Func>
+    double Gather(const Func& f) const {
+        double total = 0;
+        size_t width = 1ull << shift_;
+        #pragma omp parallel num_threads(threads_) reduction(+:total)
+        {
+            std::vector<T> sums(width);
+            #pragma omp for schedule(dynamic, 1)
+            for(size_t seg = 0; seg < seg_count_; seg++) {
+                std::fill(sums.begin(), sums.end(), T(0));
+                size_t base = seg << shift_;
+                for(size_t t = 0; t < threads_; t++) {
+                    const auto& dests = dests_[t][seg];
+                    const auto& values = values_[t][seg];
+                    for(size_t i = 0; i < dests.size(); i++) {
+                        sums[dests[i] - base] += values[i];
+                    }
+                }
+                size_t ed = std::min(base + width, v_count_);
+                for(size_t v = base; v < ed; v++) {
+                    total += f(static_cast<VertexType>(v), sums[v - base]);
+                }
+            }
+        }
+        return total;
+    }
+};
 
 template<BasicIterableTwoWayGraph GraphType>
 void pagerank_pull(const GraphType* graph, size_t iteration_count) {
@@ -90,6 +160,7 @@ void pagerank_pull(const GraphType* graph, size_t iteration_count) {
 
 template<BasicIterableGraph GraphType>
 void pagerank_push(const GraphType* graph, size_t iteration_count) {
+    using VertexType = typename GraphType::VertexType;
 
     size_t v_count = graph->VertexCount();
     auto rank_array = make_huge_for_overwrite<float[]>(v_count);
@@ -111,36 +182,24 @@ void pagerank_push(const GraphType* graph, size_t iteration_count) {
     }
 
 
+    // Contributions are binned by destination instead of atomic adds
+    PropagationBins<VertexType, float> bins(v_count);
+
     // Run pagerank
 	for (size_t iter_count = 0; iter_count < iteration_count; ++iter_count) {
         SimpleTimer iter_timer;
 
-        #pragma omp parallel 
-        {
-            float rank = 0.0f; 
-         
-            #pragma omp for schedule(dynamic, 16384)
-            for (VID v = 0; v < v_count; v++) {
-                rank = prior_rank_array[v];
-                graph->IterateNeighbors(v, [&](VID to) {
-                    qthread_dincr(&rank_array[to], rank);
-                });
-            }
-
-            if (iter_count != iteration_count - 1) {
-                #pragma omp for schedule(dynamic, 16384)
-                for (VID v = 0; v < v_count; v++) {
-                    rank_array[v] = (0.15 + 0.85 * rank_array[v]) * dset[v];
-                    prior_rank_array[v] = 0;
-                }
-            } else { 
-                #pragma omp for schedule(dynamic, 16384)
-                for (VID v = 0; v < v_count; v++) {
-                    rank_array[v] = (0.15 + 0.85 * rank_array[v]);
-                    prior_rank_array[v] = 0;
-                }
-            }
-        }
+        bins.Scatter([&](VertexType v, const auto& emit) {
+            graph->IterateNeighbors(v, emit);
+        }, [&](VertexType v) {
+            return prior_rank_array[v];
+        });
+
+        bool last = iter_count == iteration_count - 1;
+        bins.Gather([&](VertexType v, float rank) {
+            rank_array[v] = last ? (0.15 + 0.85 * rank) : (0.15 + 0.85 * rank) * dset[v];
+            return 0.0;
+        });
         std::swap(prior_rank_array, rank_array);
         fmt::println("Iteration {} time: {:.2f}s", iter_count, iter_timer.Stop());
     }	
@@ -0,0 +1,165 @@
+#ifndef __DCSR_PR_INCREMENTAL_H__
+#define __DCSR_PR_INCREMENTAL_H__
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <omp.h>
+#include "common.h"
+#include "concepts.h"
+#include "algorithms/ligra.h"
+
+namespace dcsr {
+
+/**
+ * @brief PageRank kept up to date across ingested batches by push-based residual propagation.
+ * It maintains scores x and residuals r = base + d * sum_{u->v} x[u] / deg(u) - x[v]; a push moves
+ * r[v] into x[v] and spreads d * r[v] / deg(v) to the out neighbors. Update() recomputes r exactly
+ * only for out neighbors of vertices touched by new edges (their in edges or the degrees of their
+ * in neighbors changed) and pushes until every |r[v]| <= epsilon * base, so the L1 error of scores
+ * stays below about epsilon. Same formula as pr_gapbs (no redistribution from dangling vertices).
+ * The graph needs config.track_touched and a fixed vertex count (auto_extend = false).
+ * Call Recompute()/Update() between WaitSortingAndPrepareAnalysis and FinishAlgorithm.
+ */
+template<TouchTrackingTwoWayGraph GraphType>
+class IncrementalPageRank {
+public:
+    using VID = typename GraphType::VertexType;
+    static constexpr double DAMP = 0.85;
+private:
+    GraphType* graph_;
+    const size_t v_count_;
+    const double base_;
+    const double threshold_;
+    std::unique_ptr<double[]> scores_;
+    std::unique_ptr<double[]> residuals_;
+    std::unique_ptr<uint32_t[]> degrees_;      // out degrees seen by scores
+    std::unique_ptr<uint8_t[]> flags_;         // in next push frontier, or affected in Update
+
+public:
+    IncrementalPageRank(GraphType* graph, double epsilon = 1e-4)
+    : graph_(graph), v_count_(graph->VertexCount()),
+      base_((1.0 - DAMP) / v_count_), threshold_(epsilon * base_),
+      scores_(std::make_unique_for_overwrite<double[]>(v_count_)),
+      residuals_(std::make_unique_for_overwrite<double[]>(v_count_)),
+      degrees_(std::make_unique_for_overwrite<uint32_t[]>(v_count_)),
+      flags_(std::make_unique<uint8_t[]>(v_count_)) {
+        dcsr_assert(graph->GetConfig().track_touched, "IncrementalPageRank needs config.track_touched");
+        dcsr_assert(!graph->GetConfig().auto_extend, "IncrementalPageRank needs a fixed vertex count (auto_extend = false)");
+    }
+
+    const double* Scores() const {
+        return scores_.get();
+    }
+
+    // Full computation from zero scores, returns number of push rounds
+    size_t Recompute() {
+        #pragma omp parallel for
+        for(size_t v = 0; v < v_count_; v++) {
+            scores_[v] = 0;
+            residuals_[v] = base_;
+            degrees_[v] = graph_->GetDegreeOut(v);
+            flags_[v] = 1;
+        }
+        graph_->ClearTouched();
+        std::vector<VID> frontier(v_count_);
+        #pragma omp parallel for
+        for(size_t v = 0; v < v_count_; v++) {
+            frontier[v] = v;
+        }
+        return Push(std::move(frontier));
+    }
+
+    // Fold in edges added since last Recompute/Update, returns number of push rounds
+    size_t Update() {
+        dcsr_assert(graph_->VertexCount() == v_count_, "Vertex count changed since IncrementalPageRank was created");
+        std::vector<VID> touched;
+        graph_->IterateTouchedVerticesOut([&](VID u) {
+            touched.push_back(u);
+        });
+        graph_->ClearTouched();
+
+        std::vector<std::vector<VID>> locals(omp_get_max_threads());
+        #pragma omp parallel
+        {
+            auto& local = locals[omp_get_thread_num()];
+            #pragma omp for schedule(dynamic, 64)
+            for(size_t i = 0; i < touched.size(); i++) {
+                VID u = touched[i];
+                degrees_[u] = graph_->GetDegreeOut(u);
+                graph_->IterateNeighborsOut(u, [&](VID w) {
+                    if(std::atomic_ref<uint8_t>(flags_[w]).exchange(1, std::memory_order_relaxed) == 0) {
+                        local.push_back(w);
+                    }
+                });
+            }
+        }
+        std::vector<VID> affected = VertexSubset<VID>::Concat(locals);
+
+        // Exact residuals of affected vertices with new edges and degrees
+        for(auto& local: locals) {
+            local.clear();
+        }
+        #pragma omp parallel
+        {
+            auto& local = locals[omp_get_thread_num()];
+            #pragma omp for schedule(dynamic, 64)
+            for(size_t i = 0; i < affected.size(); i++) {
+                VID v = affected[i];
+                double incoming = 0;
+                graph_->IterateNeighborsIn(v, [&](VID u) {
+                    incoming += scores_[u] / degrees_[u];
+                });
+                residuals_[v] = base_ + DAMP * incoming - scores_[v];
+                if(std::abs(residuals_[v]) > threshold_) {
+                    local.push_back(v);
+                } else {
+                    flags_[v] = 0;
+                }
+            }
+        }
+        return Push(VertexSubset<VID>::Concat(locals));
+    }
+
+private:
+    // Push residuals of frontier vertices (flags set) until all are under threshold
+    size_t Push(std::vector<VID> frontier) {
+        size_t rounds = 0;
+        std::vector<std::vector<VID>> locals(omp_get_max_threads());
+        while(!frontier.empty()) {
+            #pragma omp parallel
+            {
+                auto& local = locals[omp_get_thread_num()];
+                local.clear();
+                #pragma omp for schedule(dynamic, 256)
+                for(size_t i = 0; i < frontier.size(); i++) {
+                    VID v = frontier[i];
+                    // Clear flag before taking residual, so later pushes to v put it in next frontier
+                    std::atomic_ref<uint8_t>(flags_[v]).store(0, std::memory_order_relaxed);
+                    double r = std::atomic_ref<double>(residuals_[v]).exchange(0, std::memory_order_relaxed);
+                    scores_[v] += r;
+                    if(degrees_[v] == 0) {
+                        continue;
+                    }
+                    double share = DAMP * r / degrees_[v];
+                    graph_->IterateNeighborsOut(v, [&](VID w) {
+                        double old = std::atomic_ref<double>(residuals_[w]).fetch_add(share, std::memory_order_relaxed);
+                        if(std::abs(old + share) > threshold_ && flags_[w] == 0
+                           && std::atomic_ref<uint8_t>(flags_[w]).exchange(1, std::memory_order_relaxed) == 0) {
+                            local.push_back(w);
+                        }
+                    });
+                }
+            }
+            frontier = VertexSubset<VID>::Concat(locals);
+            rounds++;
+        }
+        return rounds;
+    }
+};
+
+} // namespace dcsr
+
+#endif // __DCSR_PR_INCREMENTAL_H__
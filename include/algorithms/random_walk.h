@@ -0,0 +1,172 @@
+#ifndef __DCSR_RANDOM_WALK_H__
+#define __DCSR_RANDOM_WALK_H__
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+#include <omp.h>
+#include "common.h"
+#include "concepts.h"
+
+namespace dcsr {
+
+struct RandomWalkConfig {
+    size_t walk_length = 80;        // vertices per walk, including the start vertex
+    size_t walks_per_vertex = 10;
+    double p = 1.0;                 // node2vec return parameter, p = q = 1 is DeepWalk
+    double q = 1.0;                 // node2vec in-out parameter
+    size_t pool_size = 4096;        // walkers in flight per thread
+    uint64_t seed = 0;
+};
+
+// Padding of a walk after it reaches a vertex without out edges
+template<typename VID>
+constexpr VID RandomWalkEnd = std::numeric_limits<VID>::max();
+
+/**
+ * @brief Run one walk from each vertex of starts, walk i is written to output[i * L, (i + 1) * L)
+ * (L = walk_length). Every thread keeps a pool of walkers, each round the walkers are grouped by
+ * partition of their current vertex and advanced by one batched, prefetched sampling pass.
+ * With p != 1 or q != 1 the step follows node2vec by rejection sampling: candidate x of a walker
+ * at v (coming from t) is accepted with probability 1/p if x == t, 1 if HasEdge(t, x), else 1/q
+ * (scaled by the max of them), rejected walkers retry in the next round.
+ */
+template<RandomWalkGraph GraphType>
+void RandomWalks(const GraphType* graph, std::span<const typename GraphType::VertexType> starts,
+                 const RandomWalkConfig& config, std::span<typename GraphType::VertexType> output) {
+    using VID = typename GraphType::VertexType;
+    struct Walker {
+        size_t id;
+        size_t step;    // index of next vertex in the walk
+        VID cur;
+        VID prev;
+    };
+    constexpr size_t CLAIM_SIZE = 256;     // walks claimed by a thread at once
+
+    const size_t length = config.walk_length;
+    const size_t walk_count = starts.size();
+    dcsr_assert(length > 0, "Walk length must be positive");
+    dcsr_assert(output.size() >= walk_count * length, "Output buffer of random walks is too small");
+
+    const bool second_order = (config.p != 1.0 || config.q != 1.0);
+    const double return_prob = 1.0 / config.p;
+    const double out_prob = 1.0 / config.q;
+    const double max_prob = std::max({return_prob, 1.0, out_prob});
+    const size_t parts = graph->MemPartitionCount();
+    std::atomic<size_t> next_claim{0};
+
+    #pragma omp parallel
+    {
+        std::mt19937_64 rng(config.seed * 0x9E3779B97F4A7C15ull + omp_get_thread_num());
+        std::uniform_real_distribution<double> accept(0.0, max_prob);
+        std::vector<Walker> pool, grouped;
+        std::vector<VID> current, candidate;
+        std::vector<size_t> part_offset(parts + 1);
+        size_t claim_st = 0, claim_ed = 0;
+
+        auto finish = [&](const Walker& w) {
+            std::fill(output.begin() + w.id * length + w.step, output.begin() + (w.id + 1) * length, RandomWalkEnd<VID>);
+        };
+
+        while(true) {
+            // Refill the pool with new walks
+            while(pool.size() < config.pool_size) {
+                if(claim_st == claim_ed) {
+                    claim_st = next_claim.fetch_add(CLAIM_SIZE, std::memory_order_relaxed);
+                    claim_ed = std::min(claim_st + CLAIM_SIZE, walk_count);
+                    if(claim_st >= walk_count) {
+                        claim_st = claim_ed = walk_count;
+                        break;
+                    }
+                }
+                size_t id = claim_st++;
+                VID start = starts[id];
+                output[id * length] = start;
+                if(length > 1) {
+                    pool.push_back(Walker{id, 1, start, start});
+                }
+            }
+            if(pool.empty()) {
+                break;
+            }
+
+            // Group walkers by partition of current vertex (counting sort)
+            std::fill(part_offset.begin(), part_offset.end(), 0);
+            for(const auto& w: pool) {
+                part_offset[graph->PartitionOf(w.cur) + 1]++;
+            }
+            for(size_t i = 0; i < parts; i++) {
+                part_offset[i + 1] += part_offset[i];
+            }
+            grouped.resize(pool.size());
+            for(const auto& w: pool) {
+                grouped[part_offset[graph->PartitionOf(w.cur)]++] = w;
+            }
+            current.resize(grouped.size());
+            for(size_t i = 0; i < grouped.size(); i++) {
+                current[i] = grouped[i].cur;
+            }
+
+            // One sample per vertex with out edges, in order of current, none for others
+            candidate.assign(current.size(), RandomWalkEnd<VID>);
+            size_t cursor = 0;
+            graph->SampleNeighborsUniformBatch(std::span<const VID>(current), 1, rng, [&](VID from, VID to) {
+                while(current[cursor] != from) {
+                    cursor++;
+                }
+                candidate[cursor++] = to;
+            });
+
+            pool.clear();
+            for(size_t i = 0; i < grouped.size(); i++) {
+                Walker w = grouped[i];
+                VID x = candidate[i];
+                if(x == RandomWalkEnd<VID>) {
+                    finish(w);
+                    continue;
+                }
+                if(second_order && w.step >= 2) {
+                    double prob = (x == w.prev) ? return_prob : (graph->HasEdge(w.prev, x) ? 1.0 : out_prob);
+                    if(accept(rng) >= prob) {
+                        pool.push_back(w);
+                        continue;
+                    }
+                }
+                output[w.id * length + w.step] = x;
+                w.prev = w.cur;
+                w.cur = x;
+                w.step++;
+                if(w.step < length) {
+                    pool.push_back(w);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief walks_per_vertex walks from every vertex (walk r * n + v starts at v),
+ * returns the walks buffer of n * walks_per_vertex * walk_length vertices, see RandomWalks.
+ */
+template<RandomWalkGraph GraphType>
+std::unique_ptr<typename GraphType::VertexType[]> random_walk(const GraphType* graph, const RandomWalkConfig& config) {
+    using VID = typename GraphType::VertexType;
+    size_t n = graph->VertexCount();
+    size_t walk_count = n * config.walks_per_vertex;
+    std::vector<VID> starts(walk_count);
+    #pragma omp parallel for
+    for(size_t i = 0; i < walk_count; i++) {
+        starts[i] = i % n;
+    }
+    auto walks = std::make_unique_for_overwrite<VID[]>(walk_count * config.walk_length);
+    RandomWalks(graph, std::span<const VID>(starts), config, std::span<VID>(walks.get(), walk_count * config.walk_length));
+    return walks;
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_RANDOM_WALK_H__
@@ -0,0 +1,106 @@
+#ifndef __DCSR_TC_INCREMENTAL_H__
+#define __DCSR_TC_INCREMENTAL_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+#include "common.h"
+#include "concepts.h"
+
+namespace dcsr {
+
+/**
+ * @brief Running triangle count of an undirected graph fed by edge batches. After a batch B is
+ * ingested, new triangles are counted from the edges of B only. With G' the graph after the batch:
+ *   S = sum over (u, v) in B of |N'(u) & N'(v)|          (CountCommonNeighbors in G')
+ *   M = sum over (u, v) in B of |N_B(u) & N'(v)| + |N'(u) & N_B(v)|   (HasEdge in G')
+ *   Y = sum over (u, v) in B of |N_B(u) & N_B(v)|       (batch adjacency only)
+ * A new triangle with k edges in B is counted k times by S, k(k-1) times by M and 3 [k = 3]
+ * times by Y, so new triangles = S - M / 2 + Y / 3. Cost is the neighborhoods of the batch
+ * edges, not the whole graph.
+ * Batches must be new edges: self loops and duplicates inside a batch are dropped, but an edge
+ * already in the graph must not be added again (tc_gapbs has the same requirement).
+ * Batches hold original IDs as passed to AddEdgeBatch; the graph's relabeler is applied if set.
+ */
+template<CommonNeighborsGraph GraphType>
+class IncrementalTriangleCount {
+public:
+    using VID = typename GraphType::VertexType;
+private:
+    uint64_t count_;
+
+public:
+    // count: triangles of the graph before the first batch (e.g. from tc_gapbs)
+    explicit IncrementalTriangleCount(uint64_t count = 0): count_(count) {}
+
+    uint64_t Count() const {
+        return count_;
+    }
+
+    /**
+     * @brief Add triangles closed by batch, which must be ingested already (call between
+     * WaitSortingAndPrepareAnalysis and FinishAlgorithm). Returns new triangles.
+     */
+    template<typename E>
+    uint64_t AddBatch(const GraphType* graph, std::span<const E> batch) {
+        // Undirected batch edges (min, max) in graph IDs, without duplicates and self loops
+        const auto* relabeler = graph->Relabeler();
+        std::vector<std::pair<VID, VID>> edges;
+        edges.reserve(batch.size());
+        for(const auto& raw: batch) {
+            auto e = relabeler ? relabeler->Apply(raw) : raw;
+            if(e.from != e.to) {
+                edges.emplace_back(std::min<VID>(e.from, e.to), std::max<VID>(e.from, e.to));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        // Batch adjacency, both directions sorted by (from, to)
+        std::vector<std::pair<VID, VID>> adj;
+        adj.reserve(edges.size() * 2);
+        for(auto [u, v]: edges) {
+            adj.emplace_back(u, v);
+            adj.emplace_back(v, u);
+        }
+        std::sort(adj.begin(), adj.end());
+        auto batch_neighbors = [&](VID x) {
+            auto st = std::lower_bound(adj.begin(), adj.end(), std::make_pair(x, VID(0)));
+            auto ed = std::lower_bound(st, adj.end(), std::make_pair(VID(x + 1), VID(0)));
+            return std::span<const std::pair<VID, VID>>(st, ed);
+        };
+
+        uint64_t s = 0, m = 0, y = 0;
+        #pragma omp parallel for reduction(+:s, m, y) schedule(dynamic, 64)
+        for(size_t i = 0; i < edges.size(); i++) {
+            auto [u, v] = edges[i];
+            s += graph->CountCommonNeighbors(u, v);
+            auto nu = batch_neighbors(u);
+            auto nv = batch_neighbors(v);
+            for(auto [x, w]: nu) {
+                m += (w != v && graph->HasEdge(v, w));
+            }
+            for(auto [x, w]: nv) {
+                m += (w != u && graph->HasEdge(u, w));
+            }
+            // Both sorted by target
+            for(size_t a = 0, b = 0; a < nu.size() && b < nv.size(); ) {
+                VID wa = nu[a].second;
+                VID wb = nv[b].second;
+                y += (wa == wb);
+                a += (wa <= wb);
+                b += (wb <= wa);
+            }
+        }
+        dcsr_assert(m % 2 == 0 && y % 3 == 0, "Batch edges must not be in graph before ingestion");
+        uint64_t added = s - m / 2 + y / 3;
+        count_ += added;
+        return added;
+    }
+};
+
+} // namespace dcsr
+
+#endif // __DCSR_TC_INCREMENTAL_H__
@@ -5,6 +5,9 @@
 #include <type_traits>
 #include <cstdint>
 #include <cstddef>
+#include <random>
+#include <span>
+#include "config.h"
 
 namespace dcsr {
 
@@ -65,6 +68,47 @@ concept ConditionalStopIterableTwoWayGraph = requires(const GraphType& g, int& o
     { g.GetDegreeOut(0) } -> std::convertible_to<size_t>;
 };
 
+// Two way graph can iterate edges as contiguous blocks (std::span<const EdgeType>)
+template<typename GraphType>
+concept SpanIterableTwoWayGraph = requires(const GraphType& g, int& output) {
+    requires BasicIterableTwoWayGraph<GraphType>;
+
+    { g.IterateNeighborSpansIn(0, [](std::span<const typename GraphType::EdgeType> s){ (void)s; }) };
+    { g.IterateNeighborSpansOut(0, [](std::span<const typename GraphType::EdgeType> s){ (void)s; }) };
+    { g.IterateNeighborSpansInRange(0, 1, [](std::span<const typename GraphType::EdgeType> s){ (void)s; }) };
+    { g.IterateNeighborSpansOutRange(0, 1, [](std::span<const typename GraphType::EdgeType> s){ (void)s; }) };
+};
+
+// Two way graph can look up neighbors of a batch of vertices with prefetching
+template<typename GraphType>
+concept BatchIterableTwoWayGraph = requires(const GraphType& g, std::span<const typename GraphType::VertexType> vertices) {
+    requires BasicIterableTwoWayGraph<GraphType>;
+
+    { g.IterateNeighborsInBatch(vertices, [](GraphType::VertexType u, GraphType::VertexType v){ (void)u; (void)v; }) };
+    { g.IterateNeighborsOutBatch(vertices, [](GraphType::VertexType u, GraphType::VertexType v){ (void)u; (void)v; }) };
+};
+
+// Two way graph which reports sources of edges added since last ClearTouched (if config.track_touched), for incremental algorithms
+template<typename GraphType>
+concept TouchTrackingTwoWayGraph = requires(GraphType& g) {
+    requires ConditionalStopIterableTwoWayGraph<GraphType>;
+
+    { g.GetConfig() } -> std::convertible_to<const Config&>;
+    { g.IterateTouchedVerticesOut([](GraphType::VertexType v){ (void)v; }) };
+    { g.ClearTouched() };
+};
+
+// Graph which can sample neighbors in batch and test edges, for random walks
+template<typename GraphType>
+concept RandomWalkGraph = requires(const GraphType& g, std::span<const typename GraphType::VertexType> vertices, std::mt19937_64& rng) {
+    requires GraphMetaInfo<GraphType>;
+
+    { g.SampleNeighborsUniformBatch(vertices, 1, rng, [](GraphType::VertexType u, GraphType::VertexType v){ (void)u; (void)v; }) };
+    { g.HasEdge(0, 1) } -> std::convertible_to<bool>;
+    { g.MemPartitionCount() } -> std::convertible_to<size_t>;
+    { g.PartitionOf(0) } -> std::convertible_to<size_t>;
+};
+
 template<typename GraphType>
 concept UndirectedGraph = requires(const GraphType& g, int& output) {
     // { g.GraphView() } -> BasicIterableGraph;
@@ -72,6 +116,16 @@ concept UndirectedGraph = requires(const GraphType& g, int& output) {
     { g.GraphView().IterateNeighborsInOrder(0, [](GraphType::VertexType v){ (void)v; }) };
 };
 
+// Undirected graph which counts common neighbors in place and tests edges, for incremental triangle counting
+template<typename GraphType>
+concept CommonNeighborsGraph = requires(const GraphType& g) {
+    requires UndirectedGraph<GraphType>;
+
+    { g.CountCommonNeighbors(0, 1) } -> std::convertible_to<size_t>;
+    { g.HasEdge(0, 1) } -> std::convertible_to<bool>;
+    { g.Relabeler() };
+};
+
 } // namespace dcsr
 
 
@@ -28,6 +28,9 @@ struct Config
 
     size_t dispatch_thread_count = 4;
 
+    // build a blocked bloom filter (1 byte per edge) for each sorted run, used by HasEdge to skip runs
+    bool edge_filter = false;
+
     size_t index_ratio = 8;     // index_size ~= edges count / index_ratio
     
     size_t init_vertex_count = 0;
@@ -42,6 +45,12 @@ struct Config
     // min batch size for sorting
     size_t sort_batch_size = 1024;
 
+    // maintain connected components by union-find while ingesting (TGraph only, needs auto_extend = false)
+    bool stream_components = false;
+
+    // record sources of new edges for IterateTouchedVertices (incremental algorithms), 1 bit per vertex
+    bool track_touched = false;
+
 
     /**
      * @brief max number of eddges stored in single WAL file.
@@ -0,0 +1,203 @@
+#ifndef __DCSR_CORO_H__
+#define __DCSR_CORO_H__
+
+#include <algorithm>
+#include <array>
+#include <coroutine>
+#include <exception>
+#include <new>
+#include <utility>
+
+namespace dcsr {
+
+/**
+ * @brief Thread local free list of coroutine frames, lookups create one frame per vertex, so
+ * frames are recycled instead of going through malloc. Frames larger than BLOCK_SIZE fall back
+ * to operator new. Frames must be freed by the thread allocated them (true for RunInterleaved).
+ */
+class CoroFramePool {
+public:
+    static constexpr size_t BLOCK_SIZE = 512;
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+    inline static thread_local FreeBlock* free_list_ = nullptr;
+
+public:
+    static void* Allocate(size_t size) {
+        if(size > BLOCK_SIZE) {
+            return ::operator new(size);
+        }
+        if(free_list_ != nullptr) {
+            FreeBlock* block = free_list_;
+            free_list_ = block->next;
+            return block;
+        }
+        return ::operator new(BLOCK_SIZE);
+    }
+
+    static void Free(void* ptr, size_t size) {
+        if(size > BLOCK_SIZE) {
+            ::operator delete(ptr);
+            return;
+        }
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = free_list_;
+        free_list_ = block;
+    }
+};
+
+/**
+ * @brief A lazily started coroutine without result, used for one lookup of RunInterleaved.
+ * It suspends at start and at every prefetch (co_await PrefetchAwaiter), and is resumed by RunInterleaved.
+ */
+class LookupTask {
+public:
+    struct promise_type {
+        LookupTask get_return_object() {
+            return LookupTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) {
+            return CoroFramePool::Allocate(size);
+        }
+        static void operator delete(void* ptr, size_t size) {
+            CoroFramePool::Free(ptr, size);
+        }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+private:
+    Handle handle_;
+
+public:
+    LookupTask(): handle_(nullptr) {}
+    explicit LookupTask(Handle h): handle_(h) {}
+    LookupTask(const LookupTask&) = delete;
+    LookupTask& operator=(const LookupTask&) = delete;
+    LookupTask(LookupTask&& other) noexcept: handle_(std::exchange(other.handle_, nullptr)) {}
+    LookupTask& operator=(LookupTask&& other) noexcept {
+        if(this != &other) {
+            Reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    ~LookupTask() {
+        Reset();
+    }
+
+    bool Empty() const {
+        return handle_ == nullptr;
+    }
+
+    bool Done() const {
+        return handle_.done();
+    }
+
+    void Resume() {
+        handle_.resume();
+    }
+
+    void Reset() {
+        if(handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+};
+
+// Issue a prefetch and suspend, let other lookups run until the line arrives
+struct PrefetchAwaiter {
+    const void* addr;
+
+    bool await_ready() const noexcept {
+        __builtin_prefetch(addr);
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Resumable lower bound of vertex v in sorted edges [first, last) (by from).
+ * Coroutines alternate `co_await PrefetchAwaiter{s.Probe()}` and `s.Step()` until Done(),
+ * ranges within one cache line are finished without suspending.
+ */
+template<typename E>
+class VertexLowerBoundStepper {
+private:
+    using VertexType = decltype(E::from);
+    const E* first_;
+    size_t len_;
+    VertexType v_;
+
+public:
+    VertexLowerBoundStepper(VertexType v, const E* first, const E* last)
+    : first_(first), len_(last - first), v_(v) {}
+
+    bool Done() const {
+        return len_ * sizeof(E) <= 64;
+    }
+
+    const E* Probe() const {
+        return first_ + len_ / 2;
+    }
+
+    void Step() {
+        size_t half = len_ / 2;
+        first_ += (first_[half].from < v_) * (len_ - half);
+        len_ = half;
+    }
+
+    // Finish remaining steps (in one cache line)
+    const E* Result() {
+        while(len_ > 0) {
+            Step();
+        }
+        return first_;
+    }
+};
+
+/**
+ * @brief Run count lookups with at most N in flight on current thread. make_task(i) returns the
+ * LookupTask of i-th lookup, tasks are resumed round robin, so that when one task waits for a
+ * prefetched line, others make progress.
+ */
+template<size_t N, typename MakeTask>
+void RunInterleaved(size_t count, const MakeTask& make_task) {
+    std::array<LookupTask, N> slots;
+    size_t next = 0;
+    size_t active = 0;
+    for(auto& slot: slots) {
+        if(next == count) {
+            break;
+        }
+        slot = make_task(next++);
+        active++;
+    }
+    while(active > 0) {
+        for(auto& slot: slots) {
+            if(slot.Empty()) {
+                continue;
+            }
+            slot.Resume();
+            if(slot.Done()) {
+                if(next < count) {
+                    slot = make_task(next++);
+                } else {
+                    slot.Reset();
+                    active--;
+                }
+            }
+        }
+    }
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_CORO_H__
@@ -42,11 +42,28 @@ T* NumaAllocArrayOnNode(size_t size, int node) {
     return static_cast<T*>(NumaAllocOnNode(sizeof(T) * size, node));
 }
 
+// Pages are spread round robin over all nodes, for arrays accessed randomly by threads of all nodes
+void* NumaAllocInterleaved(size_t size) {
+    void* ptr = numa_alloc_interleaved(size);
+    dcsr_assert(ptr != nullptr, "numa_alloc_interleaved failed");
+    return ptr;
+}
+
+template<typename T>
+T* NumaAllocArrayInterleaved(size_t size) {
+    return static_cast<T*>(NumaAllocInterleaved(sizeof(T) * size));
+}
+
 template<typename T>
 void NumaFreeArray(T* ptr, size_t size) {
     NumaFree(ptr, sizeof(T) * size);
 }
 
+// Run current thread on cpus of given node, return false if node is not available (thread is not moved)
+bool NumaRunOnNode(int node) {
+    return numa_run_on_node(node) == 0;
+}
+
 // mmap_uptr
 
 template<typename T>
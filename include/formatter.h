@@ -136,23 +136,29 @@ struct fmt::formatter<dcsr::Config> {
             "buffer_count = {:L}\n"
             "buffer_size = {:L}\n"
             "compaction_threshold = {:L}\n"
+            "edge_filter = {}\n"
             "index_ratio = {:L}\n"
             "init_vertex_count = {:L}\n"
             "merge_multiplier = {:L}\n"
             "min_csr_num_to_compact = {:L}\n"
             "partition_size = {:L}\n"
             "sort_batch_size = {:L}\n"
+            "stream_components = {}\n"
+            "track_touched = {}\n"
             "======================================================\n",
             c.auto_extend,
             c.buffer_count,
             c.buffer_size,
             c.compaction_threshold,
+            c.edge_filter,
             c.index_ratio,
             c.init_vertex_count,
             c.merge_multiplier,
             c.min_csr_num_to_compact,
             c.partition_size,
-            c.sort_batch_size
+            c.sort_batch_size,
+            c.stream_components,
+            c.track_touched
         );
     }
 };
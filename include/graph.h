@@ -1,11 +1,15 @@
 #ifndef __DCSR_GRAPH_H__
 #define __DCSR_GRAPH_H__
 
+#include <array>
+#include <bitset>
 #include <mutex>
+#include <random>
 #include <omp.h>
 #include <unistd.h>
 #include <fcntl.h>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/container/static_vector.hpp>
 #include <boost/dynamic_bitset.hpp>
 
@@ -18,14 +22,19 @@
 #include "checker.h"
 #include "common.h"
 #include "config.h"
+#include "coro.h"
 #include "datatype.h"
 #include "env.h"
 #include "filename.h"
 #include "formatter.h"
+#include "intersect.h"
 #include "mergeable_ranges.h"
 #include "metrics.h"
 #include "ring_buffer.h"
+#include "search_policy.h"
 #include "sort.h"
+#include "relabel.h"
+#include "union_find.h"
 #include "vec.h"
 
 namespace dcsr {
@@ -88,6 +97,29 @@ public:
         return std::span<const E>(edges + st, ed - st);
     }
 
+    const OffType* BucketOffsetAddress(VID v) const {
+        return index_ + key_func_(v);
+    }
+
+    // Prefetch offsets of bucket of v
+    void PrefetchBucketOffset(VID v) const {
+        size_t idx = key_func_(v);
+        if(idx != 0) {
+            __builtin_prefetch(index_ + idx - 1);
+        }
+        __builtin_prefetch(index_ + idx);
+    }
+
+    // Prefetch first probe of searching v in its bucket (offsets should be already in cache)
+    template<typename E>
+    void PrefetchBucket(E* edges, VID v) const {
+        auto bucket = GetBucket(edges, v);
+        if(!bucket.empty()) {
+            __builtin_prefetch(bucket.data() + bucket.size() / 2);
+            __builtin_prefetch(bucket.data());
+        }
+    }
+
     bool IsPerVertexBucket() const {
         return key_func_.IsPerVertexBucket();
     }
@@ -105,7 +137,98 @@ public:
     }
 };
 
-template<typename E, bool NeighborsOrder=false, bool StdSort=false>
+/**
+ * @brief Index over the unsorted tail (ReadyData) of a memory partition.
+ * Tail edges are copied and sorted by Comparator, then an open addressing table maps the local
+ * vertex id (from - vstart) to its edges. Storage is allocated once with the max tail size,
+ * so building never allocates.
+ */
+template<typename E, typename Comparator>
+class TailIndex {
+private:
+    struct Slot {
+        uint32_t key;   // local vertex id + 1, 0 for empty slot
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    const size_t capacity_;
+    const size_t slot_mask_;
+    std::unique_ptr<E[]> edges_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t size_;
+    bool valid_;
+
+    size_t Hash(uint32_t key) const {
+        return ((key * 0x9E3779B97F4A7C15ull) >> 32) & slot_mask_;
+    }
+
+public:
+    TailIndex(size_t capacity)
+    : capacity_(capacity), slot_mask_(std::bit_ceil(capacity * 2) - 1),
+      edges_(new E[capacity]), slots_(new Slot[slot_mask_ + 1]()),
+      size_(0), valid_(false) {}
+
+    void Build(std::span<const E> tail, uint64_t vstart) {
+        dcsr_assert(tail.size() <= capacity_, "Tail is larger than capacity of tail index");
+        std::fill_n(slots_.get(), slot_mask_ + 1, Slot{0, 0, 0});
+        size_ = tail.size();
+        std::copy(tail.begin(), tail.end(), edges_.get());
+        std::sort(edges_.get(), edges_.get() + size_, Comparator());
+
+        size_t i = 0;
+        while(i < size_) {
+            size_t j = i + 1;
+            while(j < size_ && edges_[j].from == edges_[i].from) {
+                j++;
+            }
+            uint32_t key = static_cast<uint32_t>(edges_[i].from - vstart) + 1;
+            size_t pos = Hash(key);
+            while(slots_[pos].key != 0) {
+                pos = (pos + 1) & slot_mask_;
+            }
+            slots_[pos] = Slot{key, static_cast<uint32_t>(i), static_cast<uint32_t>(j)};
+            i = j;
+        }
+        valid_ = true;
+    }
+
+    // All tail edges, sorted by Comparator
+    std::span<const E> Edges() const {
+        return std::span<const E>(edges_.get(), size_);
+    }
+
+    // Edges in tail whose source is local vertex `local`, sorted by Comparator
+    std::span<const E> Find(uint64_t local) const {
+        uint32_t key = static_cast<uint32_t>(local) + 1;
+        size_t pos = Hash(key);
+        while(slots_[pos].key != 0) {
+            if(slots_[pos].key == key) {
+                return std::span<const E>(edges_.get() + slots_[pos].begin, slots_[pos].end - slots_[pos].begin);
+            }
+            pos = (pos + 1) & slot_mask_;
+        }
+        return {};
+    }
+
+    const void* SlotAddress(uint64_t local) const {
+        return slots_.get() + Hash(static_cast<uint32_t>(local) + 1);
+    }
+
+    void Prefetch(uint64_t local) const {
+        __builtin_prefetch(SlotAddress(local));
+    }
+
+    bool Valid() const {
+        return valid_;
+    }
+
+    void Invalidate() {
+        valid_ = false;
+    }
+};
+
+template<typename E, bool NeighborsOrder=false, bool StdSort=false, SearchPolicy Search=DefaultSearchPolicy>
 class SortBasedMemPartition {
 public:
     using VertexType = E::VertexType;
@@ -128,7 +251,16 @@ public:
     // static const size_t ENABLE_STEAL_THRESHOLD = 1024ull * 1024ull * 1024;
     static const size_t MAX_STEAL_SIZE = 32 * 1024;
     static const size_t MIN_STEAL_SIZE = 512;
+    static const size_t EDGES_PER_FILTER_WORD = 8;  // 8 bits per edge
+    static const size_t FENCE_OCCUPANCY_BITS = 256;
 private:
+    // Fence pointer of a sorted run, queries skip runs which can't hold the vertex
+    struct RunFence {
+        VID min_from;
+        VID max_from;
+        std::bitset<FENCE_OCCUPANCY_BITS> occupancy;    // bit i: some edge from local vertices [i << fence_shift_, (i+1) << fence_shift_)
+    };
+
     // Meta Infomation
     const size_t pid_;
     const VID vid_start_;
@@ -142,6 +274,7 @@ private:
     const size_t index_ratio_;
     const size_t index_ratio_bits_;
     const int numa_node_;
+    const size_t fence_shift_;
 
     // Buffer
     // BatchRingBuffer<EdgeType> ring_buffer_;
@@ -157,10 +290,15 @@ private:
 
     // Index
     mergeable_ranges<MAX_RANGES_COUNT> sorted_ranges_;
+    boost::container::static_vector<RunFence, MAX_RANGES_COUNT> run_fences_;  // parallel to sorted_ranges_
     uint32_t* current_batch_index_;
     uint32_t* first_level_index_;
+    uint32_t* sorted_degree_;   // sorted edges count of each vertex, maintained by writer
     BitSet nonempty_bitset_;
     bool bitset_valid_;
+    TailIndex<EdgeType, EdgeSortComparator> tail_index_;
+    uint64_t* edge_filter_;     // blocked bloom filter, run [st, ed) owns words [st/8, ed/8), nullptr if disabled
+    BitSet touched_;            // vertices with edges sorted or tail indexed since last ClearTouched, empty unless config.track_touched
     
 
     // Mutex
@@ -184,6 +322,7 @@ public:
       index_ratio_(c.index_ratio),
       index_ratio_bits_(std::bit_width(c.index_ratio - 1)),
       numa_node_(numa_node),
+      fence_shift_(std::max<int>(0, std::bit_width(vcount - 1) - std::bit_width(FENCE_OCCUPANCY_BITS - 1))),
       // ring_buffer_(c.buffer_size * c.buffer_count, c.sort_batch_size, c.buffer_size),
       ring_buffer_(c.buffer_size * c.buffer_count, c.sort_batch_size, c.dispatch_thread_count, numa_node),
       sort_times_{0}, sorted_count_{0},
@@ -192,17 +331,27 @@ public:
       steal_sorted_count_{0},
       nonempty_bitset_{},
       bitset_valid_{false},
+      tail_index_{ring_buffer_.ReadyDataCapacity()},
+      touched_(c.track_touched ? vcount : 0),
       reading_mutex_{},
       initialized_{}
     {
         dcsr_assert((flush_batch_size_ % index_ratio_) == 0, "Flush batch size must be multiple of index ratio");
         current_batch_index_ = new uint32_t[flush_batch_size_ / index_ratio_];
         first_level_index_ = new uint32_t[width_];
+        sorted_degree_ = new uint32_t[width_]();
+        edge_filter_ = nullptr;
+        if(c.edge_filter) {
+            dcsr_assert((minimum_sort_batch_ % EDGES_PER_FILTER_WORD) == 0, "Sort batch size must be multiple of 8 to enable edge filter");
+            edge_filter_ = new uint64_t[flush_batch_size_ / EDGES_PER_FILTER_WORD]();
+        }
     }
 
     ~SortBasedMemPartition() {
         delete[] current_batch_index_;
         delete[] first_level_index_;
+        delete[] sorted_degree_;
+        delete[] edge_filter_;
         // sfmt::println("~MemPartition[{}]: edges: {:L}, sorted ranges: {}", pid_, sorted_count_, sorted_ranges_.size());
         // size_t unsorted_edges = ring_buffer_.ReadyData().size();
         // fmt::println("~MemPartition[{}]: edges: {:L}, search_unsorted_time: {:.2f}s ({} Edges)", 
@@ -224,6 +373,10 @@ public:
         ring_buffer_.Collect();
     }
 
+    int NumaNode() const {
+        return numa_node_;
+    }
+
     // 如果当前可见的 batch 大小足够，就排序一个 mini batch
     bool SortVisible() {
         size_t visible_size = ring_buffer_.VisibleBatchSize();
@@ -299,23 +452,25 @@ public:
 
         // SimpleTimer timer;
         // Unsorted part
-        auto unsorted = ring_buffer_.ReadyData();
-        for(const auto& e: unsorted) {
-            if(e.from == v) {
-                neighbors.push_back(e);
-            }
-        }
+        IterateUnsortedEdges(v, [&](const EdgeType& e) {
+            neighbors.push_back(e);
+            return true;
+        });
         // search_unsorted_time_ += timer.Stop();
 
         RUN_IN_DEBUG {
-            fmt::println("Unsorted part size: {}", unsorted.size());
+            fmt::println("Unsorted part size: {}", ring_buffer_.ReadyData().size());
             fmt::println("neigh: {::t}", neighbors);
             fmt::println("Ranges: {}", sorted_ranges_.to_string());
         }
 
         // fmt::println("Ranges: {}", sorted_ranges_.to_string());
 
-        for(const auto& r: sorted_ranges_) {
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            if(!RunMayHold(i, v)) {
+                continue;
+            }
+            const auto& r = sorted_ranges_[i];
             const EdgeType* st = current_batch_ + r.first;
             const EdgeType* ed = current_batch_ + r.second;
 
@@ -361,7 +516,11 @@ public:
             return;
         }
 
-        for(const auto& r: sorted_ranges_) {
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            if(!RunMayHold(i, v)) {
+                continue;
+            }
+            const auto& r = sorted_ranges_[i];
             const EdgeType* st = current_batch_ + r.first;
             const EdgeType* ed = current_batch_ + r.second;
 
@@ -403,20 +562,15 @@ public:
 
         // // SimpleTimer timer;
         // // Unsorted part
-        auto unsorted = ring_buffer_.ReadyData();
-        for(const auto& e: unsorted) {
-            if(e.from == v) {
-                // Support early break
-                if constexpr (std::is_same_v<std::invoke_result_t<Func, VID>, bool>) {
-                    bool cont = func(e.to);
-                    if(!cont) {
-                        return;
-                    }
-                } else {
-                    func(e.to);
-                }
+        IterateUnsortedEdges(v, [&](const EdgeType& e) {
+            // Support early break
+            if constexpr (std::is_same_v<std::invoke_result_t<Func, VID>, bool>) {
+                return func(e.to);
+            } else {
+                func(e.to);
+                return true;
             }
-        }
+        });
         // // search_unsorted_time_ += timer.Stop();
 
         // RUN_IN_DEBUG {
@@ -429,43 +583,248 @@ public:
     }
 
 
-    size_t GetDegree(VID v) const {
+    /**
+     * @brief Iterate edges of v as contiguous blocks, one block per sorted run and one for the tail
+     * (the tail gives single-edge blocks if tail index is not built), so consumers can unroll or
+     * vectorize over the block. func(std::span<const EdgeType>) may return bool, false to stop.
+     */
+    template<typename Func>
+        requires std::invocable<Func, std::span<const EdgeType>>
+    void IterateNeighborSpans(VID v, const Func& func) const {
         if(bitset_valid_ && !nonempty_bitset_[v - vid_start_]) {
-            return 0;
+            return;
         }
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            auto edges = VertexEdgesInRun(i, v);
+            if(!edges.empty() && !InvokeSpanFunc(func, edges)) {
+                return;
+            }
+        }
+        if(tail_index_.Valid()) {
+            auto edges = tail_index_.Find(v - vid_start_);
+            if(!edges.empty()) {
+                InvokeSpanFunc(func, edges);
+            }
+            return;
+        }
+        for(const auto& e: ring_buffer_.ReadyData()) {
+            if(e.from == v && !InvokeSpanFunc(func, std::span<const EdgeType>(&e, 1))) {
+                return;
+            }
+        }
+    }
 
-        size_t degree = 0;
+    /**
+     * @brief Iterate edges whose source in [v1, v2) as contiguous blocks (sorted by source in each
+     * block), see IterateNeighborSpans.
+     */
+    template<typename Func>
+        requires std::invocable<Func, std::span<const EdgeType>>
+    void IterateNeighborSpansRange(VID v1, VID v2, const Func& func) const {
+        v1 = std::max(v1, vid_start_);
+        v2 = std::min(v2, vid_start_ + width_);
+        if(v1 >= v2) {
+            return;
+        }
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            if(v2 <= run_fences_[i].min_from || v1 > run_fences_[i].max_from) {
+                continue;
+            }
+            const EdgeType* range_st = current_batch_ + sorted_ranges_[i].first;
+            const EdgeType* range_ed = current_batch_ + sorted_ranges_[i].second;
+            auto index = GetRelatedIndexWrapper(range_st, range_ed);
+            auto b1 = index.GetBucket(range_st, v1);
+            const EdgeType* st = BinarySearchVertexInRange(v1, b1.data(), b1.data() + b1.size());
+            const EdgeType* ed = range_ed;
+            if(v2 < vid_start_ + width_) {
+                auto b2 = index.GetBucket(range_st, v2);
+                ed = BinarySearchVertexInRange(v2, b2.data(), b2.data() + b2.size());
+            }
+            if(st < ed && !InvokeSpanFunc(func, std::span<const EdgeType>(st, ed))) {
+                return;
+            }
+        }
+        if(tail_index_.Valid()) {
+            auto tail = tail_index_.Edges();
+            auto st = LowerBound(tail.data(), tail.data() + tail.size(), EdgeType(v1, 0), CmpFrom<EdgeType>());
+            auto ed = LowerBound(st, tail.data() + tail.size(), EdgeType(v2, 0), CmpFrom<EdgeType>());
+            if(st < ed) {
+                InvokeSpanFunc(func, std::span<const EdgeType>(st, ed));
+            }
+            return;
+        }
+        for(const auto& e: ring_buffer_.ReadyData()) {
+            if(e.from >= v1 && e.from < v2 && !InvokeSpanFunc(func, std::span<const EdgeType>(&e, 1))) {
+                return;
+            }
+        }
+    }
 
-        // Unsorted part
-        auto unsorted = ring_buffer_.ReadyData();
-        for(const auto& e: unsorted) {
-            if(e.from == v) {
-                degree++;
+    /**
+     * @brief Draw k neighbors of v uniformly at random (with replacement), func(VID to).
+     * Edge counts of v in every run and the tail form a prefix sum, a random edge index is mapped
+     * to (block, offset) by scanning it, the neighborhood is not materialized.
+     */
+    template<typename RNG, typename Func>
+        requires std::invocable<Func, VID>
+    void SampleNeighborsUniform(VID v, size_t k, RNG& rng, const Func& func) const {
+        if(k == 0 || (bitset_valid_ && !nonempty_bitset_[v - vid_start_])) {
+            return;
+        }
+        boost::container::static_vector<std::span<const EdgeType>, MAX_RANGES_COUNT + 1> blocks;
+        boost::container::static_vector<size_t, MAX_RANGES_COUNT + 1> block_start;
+        size_t total = 0;
+        auto add_block = [&](std::span<const EdgeType> edges) {
+            if(!edges.empty()) {
+                blocks.push_back(edges);
+                block_start.push_back(total);
+                total += edges.size();
             }
+        };
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            add_block(VertexEdgesInRun(i, v));
+        }
+        boost::container::small_vector<EdgeType, 16> unindexed_tail;
+        if(tail_index_.Valid()) {
+            add_block(tail_index_.Find(v - vid_start_));
+        } else {
+            IterateUnsortedEdges(v, [&](const EdgeType& e) {
+                unindexed_tail.push_back(e);
+                return true;
+            });
+            add_block(std::span<const EdgeType>(unindexed_tail.data(), unindexed_tail.size()));
+        }
+        if(total == 0) {
+            return;
         }
 
-        for(const auto& r: sorted_ranges_) {
+        std::uniform_int_distribution<size_t> dist(0, total - 1);
+        for(size_t s = 0; s < k; s++) {
+            size_t idx = dist(rng);
+            size_t j = 0;
+            while(j + 1 < blocks.size() && idx >= block_start[j + 1]) {
+                j++;
+            }
+            func(blocks[j][idx - block_start[j]].to);
+        }
+    }
+
+    /**
+     * @brief Stages of batched lookup (see Graph::IterateNeighborsBatch), each stage only issues
+     * prefetches for v, so that cache misses of many vertices overlap.
+     * Stage 1: bucket offsets of v in every run, and tail index slot.
+     */
+    void PrefetchIndex(VID v) const {
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            if(!RunMayHold(i, v)) {
+                continue;
+            }
+            const auto& r = sorted_ranges_[i];
+            auto index = GetRelatedIndexWrapper(current_batch_ + r.first, current_batch_ + r.second);
+            index.PrefetchBucketOffset(v);
+        }
+        if(tail_index_.Valid()) {
+            tail_index_.Prefetch(v - vid_start_);
+        }
+    }
+
+    // Stage 2: first probe of v in its bucket of every run, offsets prefetched by stage 1
+    void PrefetchBuckets(VID v) const {
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            if(!RunMayHold(i, v)) {
+                continue;
+            }
+            const auto& r = sorted_ranges_[i];
             const EdgeType* st = current_batch_ + r.first;
-            const EdgeType* ed = current_batch_ + r.second;
+            auto index = GetRelatedIndexWrapper(st, current_batch_ + r.second);
+            index.PrefetchBucket(st, v);
+        }
+    }
 
-            auto index = GetRelatedIndexWrapper(st, ed);
-            auto range = index.GetBucket(st, v);
+    /**
+     * @brief Coroutine version of IterateNeighbors, for RunInterleaved (coro.h). It suspends after
+     * prefetching bucket offsets and every probe of the binary search that leaves current cache line.
+     * (*func)(from, to) may return bool, false to stop.
+     */
+    template<typename Func>
+        requires std::invocable<Func, VID, VID>
+    LookupTask IterateNeighborsCoro(VID v, const Func* func) const {
+        constexpr bool breakable = std::is_same_v<std::invoke_result_t<Func, VID, VID>, bool>;
+        if(bitset_valid_ && !nonempty_bitset_[v - vid_start_]) {
+            co_return;
+        }
 
-            if(range.empty()) {
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            if(!RunMayHold(i, v)) {
                 continue;
             }
+            const EdgeType* st = current_batch_ + sorted_ranges_[i].first;
+            const EdgeType* ed = current_batch_ + sorted_ranges_[i].second;
+            auto index = GetRelatedIndexWrapper(st, ed);
+            co_await PrefetchAwaiter{index.BucketOffsetAddress(v)};
 
-            if(index.IsPerVertexBucket()) {
-                degree += range.size();
+            auto bucket = index.GetBucket(st, v);
+            if(bucket.empty()) {
                 continue;
             }
+            VertexLowerBoundStepper<EdgeType> search(v, bucket.data(), bucket.data() + bucket.size());
+            while(!search.Done()) {
+                co_await PrefetchAwaiter{search.Probe()};
+                search.Step();
+            }
+            for(const EdgeType* it = search.Result(); it != ed && it->from == v; it++) {
+                if constexpr (breakable) {
+                    if(!(*func)(v, it->to)) {
+                        co_return;
+                    }
+                } else {
+                    (*func)(v, it->to);
+                }
+            }
+        }
 
-            const EdgeType* rst = range.data();
-            const EdgeType* red = range.data() + range.size();
+        if(tail_index_.Valid()) {
+            co_await PrefetchAwaiter{tail_index_.SlotAddress(v - vid_start_)};
+        }
+        IterateUnsortedEdges(v, [&](const EdgeType& e) {
+            if constexpr (breakable) {
+                return (*func)(v, e.to);
+            } else {
+                (*func)(v, e.to);
+                return true;
+            }
+        });
+    }
+
+    /**
+     * @brief Whether edge (u, v) exists. Runs rejected by the edge filter are skipped without touching
+     * their edges. With NeighborsOrder a run is one binary search on (from, to), otherwise edges of u are scanned.
+     */
+    bool HasEdge(VID u, VID v) const {
+        if(bitset_valid_ && !nonempty_bitset_[u - vid_start_]) {
+            return false;
+        }
+        uint64_t hash = EdgeHash(u, v);
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            if(RunMayHold(i, u) && RunMayContain(i, hash) && EdgeInRun(i, u, v)) {
+                return true;
+            }
+        }
+        bool found = false;
+        IterateUnsortedEdges(u, [&](const EdgeType& e) {
+            found = (static_cast<VID>(e.to) == v);
+            return !found;
+        });
+        return found;
+    }
 
-            degree += BinarySearchVertexCountInRange(v, rst, red);
+    // Sorted edges are counted by writer (sorted_degree_), only the unsorted tail is searched
+    size_t GetDegree(VID v) const {
+        size_t local = v - vid_start_;
+        if(bitset_valid_ && !nonempty_bitset_[local]) {
+            return 0;
         }
-        return degree;
+        return sorted_degree_[local] + UnsortedDegree(v);
     }
 
     /**
@@ -1027,23 +1386,30 @@ public:
             return;
         }
 
+        // Unsorted part, already sorted by target in tail index
         std::vector<EdgeType> unsort_neighbors;
-
-        // Unsorted part
-        auto unsorted = ring_buffer_.ReadyData();
-        for(const auto& e: unsorted) {
-            if(e.from == v) {
-                unsort_neighbors.push_back(e);
+        std::span<const EdgeType> unsort_span;
+        if(tail_index_.Valid()) {
+            unsort_span = tail_index_.Find(v - vid_start_);
+        } else {
+            for(const auto& e: ring_buffer_.ReadyData()) {
+                if(e.from == v) {
+                    unsort_neighbors.push_back(e);
+                }
             }
+            // Sort unsorted part in vector
+            pdqsort_branchless(unsort_neighbors.begin(), unsort_neighbors.end(), CmpTo<EdgeType>());
+            unsort_span = unsort_neighbors;
         }
 
-        // Sort unsorted part in vector
-        pdqsort_branchless(unsort_neighbors.begin(), unsort_neighbors.end(), CmpTo<EdgeType>());
-
         // Insert all ranges into a vector, sort ranges by first element's target vertex
         using Range = std::pair<const EdgeType*, const EdgeType*>;
         std::vector<Range> ranges;
-        for(const auto& r: sorted_ranges_) {
+        for(size_t i = 0; i < sorted_ranges_.size(); i++) {
+            if(!RunMayHold(i, v)) {
+                continue;
+            }
+            const auto& r = sorted_ranges_[i];
             const EdgeType* st = current_batch_ + r.first;
             const EdgeType* ed = current_batch_ + r.second;
 
@@ -1061,8 +1427,8 @@ public:
                 ranges.push_back({it, red});
             }
         }
-        if(!unsort_neighbors.empty()) {
-            ranges.push_back({unsort_neighbors.data(), unsort_neighbors.data() + unsort_neighbors.size()});
+        if(!unsort_span.empty()) {
+            ranges.push_back({unsort_span.data(), unsort_span.data() + unsort_span.size()});
         }
 
         auto cmp_range_first = [&](Range a, Range b) {
@@ -1152,34 +1518,194 @@ public:
         bitset_valid_ = true;
     }
 
+    // Index unsorted tail for point lookups, call when writer is paused (holding reading mutex)
+    void BuildTailIndex() {
+        tail_index_.Build(ring_buffer_.ReadyData(), vid_start_);
+        if(!touched_.empty()) {
+            for(const EdgeType& e: ring_buffer_.ReadyData()) {
+                touched_.set(e.from - vid_start_);
+            }
+        }
+    }
+
+    void InvalidateTailIndex() {
+        tail_index_.Invalidate();
+    }
+
+    /**
+     * @brief Vertices which got new edges since last ClearTouched, func(VID). An edge marks its
+     * source when it is sorted or indexed in the tail, so edges in the tail may be reported again
+     * once sorted. Nothing is reported unless config.track_touched. Call when writer is paused
+     * (holding reading mutex).
+     */
+    template<typename Func>
+        requires std::invocable<Func, VID>
+    void IterateTouchedVertices(const Func& func) const {
+        for(size_t i = touched_.find_first(); i != BitSet::npos; i = touched_.find_next(i)) {
+            func(static_cast<VID>(vid_start_ + i));
+        }
+    }
+
+    void ClearTouched() {
+        touched_.reset();
+    }
+
 private:
+    // Call span func, return false if it asks to stop
+    template<typename Func>
+    static bool InvokeSpanFunc(const Func& func, std::span<const EdgeType> edges) {
+        if constexpr (std::is_same_v<std::invoke_result_t<Func, std::span<const EdgeType>>, bool>) {
+            return func(edges);
+        } else {
+            func(edges);
+            return true;
+        }
+    }
+
+    // Edges of v in i-th sorted run, contiguous
+    std::span<const EdgeType> VertexEdgesInRun(size_t i, VID v) const {
+        if(!RunMayHold(i, v)) {
+            return {};
+        }
+        const EdgeType* st = current_batch_ + sorted_ranges_[i].first;
+        const EdgeType* ed = current_batch_ + sorted_ranges_[i].second;
+        auto index = GetRelatedIndexWrapper(st, ed);
+        auto bucket = index.GetBucket(st, v);
+        if(bucket.empty() || index.IsPerVertexBucket()) {
+            return bucket;
+        }
+        const EdgeType* bst = bucket.data();
+        const EdgeType* bed = bucket.data() + bucket.size();
+        const EdgeType* vst = BinarySearchVertexInRange(v, bst, bed);
+        const EdgeType* ved = ExponentialSearchVertex2(v + 1, vst, bed);
+        return std::span<const EdgeType>(vst, ved);
+    }
+
+    // False if fence pointer of i-th run proves that it has no edge from v
+    bool RunMayHold(size_t i, VID v) const {
+        const RunFence& fence = run_fences_[i];
+        return v >= fence.min_from && v <= fence.max_from && fence.occupancy[(v - vid_start_) >> fence_shift_];
+    }
+
+    // Internal only, set fence of the last sorted run [begin, end)
+    void BuildRunFence(const EdgeType* begin, const EdgeType* end) {
+        run_fences_.resize(sorted_ranges_.size());
+        RunFence& fence = run_fences_.back();
+        fence.min_from = begin->from;
+        fence.max_from = (end - 1)->from;
+        fence.occupancy.reset();
+        for(const EdgeType* it = begin; it != end; it++) {
+            fence.occupancy.set((it->from - vid_start_) >> fence_shift_);
+        }
+    }
+
+    bool EdgeInRun(size_t i, VID u, VID v) const {
+        if constexpr (NeighborsOrder) {
+            const EdgeType* st = current_batch_ + sorted_ranges_[i].first;
+            const EdgeType* ed = current_batch_ + sorted_ranges_[i].second;
+            auto bucket = GetRelatedIndexWrapper(st, ed).GetBucket(st, u);
+            const EdgeType* bed = bucket.data() + bucket.size();
+            auto it = LowerBound(bucket.data(), bed, v, [u](const EdgeType& e, VID to) {
+                return (e.from < u) | ((e.from == u) & (static_cast<VID>(e.to) < to));
+            });
+            return it != bed && it->from == u && static_cast<VID>(it->to) == v;
+        } else {
+            for(const auto& e: VertexEdgesInRun(i, u)) {
+                if(static_cast<VID>(e.to) == v) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    static uint64_t EdgeHash(VID u, VID v) {
+        uint64_t h = static_cast<uint64_t>(u) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(v);
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ull;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // One word of the run is selected by high 32 bits of hash, 3 bits in the word by low bits
+    static uint64_t FilterMask(uint64_t hash) {
+        return (1ull << (hash & 63)) | (1ull << ((hash >> 6) & 63)) | (1ull << ((hash >> 12) & 63));
+    }
+
+    uint64_t* FilterWord(size_t st_off, size_t ed_off, uint64_t hash) const {
+        size_t st_word = st_off / EDGES_PER_FILTER_WORD;
+        size_t words = ed_off / EDGES_PER_FILTER_WORD - st_word;
+        return edge_filter_ + st_word + (((hash >> 32) * words) >> 32);
+    }
+
+    // False if the edge filter proves that i-th run has no edge of given hash
+    bool RunMayContain(size_t i, uint64_t hash) const {
+        if(edge_filter_ == nullptr) {
+            return true;
+        }
+        uint64_t mask = FilterMask(hash);
+        return (*FilterWord(sorted_ranges_[i].first, sorted_ranges_[i].second, hash) & mask) == mask;
+    }
+
+    // Internal only, rebuild edge filter words of a sorted run
+    void BuildEdgeFilter(const EdgeType* begin, const EdgeType* end) {
+        if(edge_filter_ == nullptr) {
+            return;
+        }
+        size_t st_off = begin - current_batch_;
+        size_t ed_off = end - current_batch_;
+        std::fill(edge_filter_ + st_off / EDGES_PER_FILTER_WORD, edge_filter_ + ed_off / EDGES_PER_FILTER_WORD, 0);
+        for(const EdgeType* it = begin; it != end; it++) {
+            uint64_t hash = EdgeHash(it->from, it->to);
+            *FilterWord(st_off, ed_off, hash) |= FilterMask(hash);
+        }
+    }
+
+    /**
+     * @brief Iterate unsorted edges of v, use tail index if it is built, otherwise scan the tail.
+     * func(const EdgeType&) returns false to stop.
+     */
+    template<typename Func>
+    void IterateUnsortedEdges(VID v, const Func& func) const {
+        if(tail_index_.Valid()) {
+            for(const auto& e: tail_index_.Find(v - vid_start_)) {
+                if(!func(e)) {
+                    return;
+                }
+            }
+            return;
+        }
+        for(const auto& e: ring_buffer_.ReadyData()) {
+            if(e.from == v && !func(e)) {
+                return;
+            }
+        }
+    }
+
+    size_t UnsortedDegree(VID v) const {
+        if(tail_index_.Valid()) {
+            return tail_index_.Find(v - vid_start_).size();
+        }
+        size_t degree = 0;
+        for(const auto& e: ring_buffer_.ReadyData()) {
+            degree += (e.from == v);
+        }
+        return degree;
+    }
+
     template <class ForwardIt, class T, class Compare>
     static constexpr ForwardIt LowerBound(ForwardIt first, ForwardIt last, const T& value, const Compare& comp) {
-        return std::lower_bound(first, last, value, comp);
-        // return sb_lower_bound(first, last, value, comp);
-        // return sbm_lower_bound(first, last, value, comp);
-        // return sbpm_lower_bound(first, last, value, comp);
-        // return branchless_lower_bound(first, last, value, comp);
-        // return asm_lower_bound(first, last, value, comp);
+        return Search::LowerBound(first, last, value, comp);
     }
 
 
     static const EdgeType* BinarySearchVertexInRange(VID v, const EdgeType* st, const EdgeType* ed) {
         return LowerBound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
-        // return std::lower_bound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
-        // return sbm_lower_bound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
-        // return sbpm_lower_bound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
     }
 
     static size_t BinarySearchVertexCountInRange(VID v, const EdgeType* st, const EdgeType* ed) {
         const EdgeType* rst = LowerBound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
         const EdgeType* red = LowerBound(st, ed, EdgeType(v+1, 0), CmpFrom<EdgeType>());
-        // EdgeType* rst = std::lower_bound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
-        // EdgeType* red = std::upper_bound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
-        // EdgeType* rst = sbm_lower_bound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
-        // EdgeType* red = sbm_lower_bound(st, ed, EdgeType(v+1, 0), CmpFrom<EdgeType>());
-        // EdgeType* rst = sbpm_lower_bound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
-        // EdgeType* red = sbpm_lower_bound(st, ed, EdgeType(v+1, 0), CmpFrom<EdgeType>());
         return red - rst;
     }
 
@@ -1195,52 +1721,6 @@ private:
         return LowerBound(st + last, std::min(st + i, ed), EdgeType(v, 0), CmpFrom<EdgeType>());
     }
 
-    template<size_t Scan, size_t FirstStep, size_t Multiplier>
-    static const EdgeType* ExponentialSearchVertexTemp(VID v, const EdgeType* st, const EdgeType* ed) {
-        const EdgeType* scan_ed = st + std::min<size_t>(Scan, ed - st);
-        while(st < scan_ed) {
-            if(st->from >= v) {
-                return st;
-            }
-            st++;
-        }
-
-        size_t i = FirstStep;
-        size_t last = 0;
-        while(st + i < ed) {
-            if((st + i)->from < v) {
-                last = i;
-                i *= Multiplier;
-            } else {
-                break;
-            }
-        }
-        return LowerBound(st + last, std::min(st + i, ed), EdgeType(v, 0), CmpFrom<EdgeType>());
-    }
-
-    template<size_t Scan, size_t FirstStep, size_t Multiplier>
-    static const EdgeType* ExponentialSearchVertexTemp2(VID v, const EdgeType* st, const EdgeType* ed) {
-        const EdgeType* scan_ed = st + std::min<size_t>(Scan, ed - st);
-        while(st < scan_ed) {
-            if(st->from >= v) {
-                return st;
-            }
-            st++;
-        }
-
-        size_t i = FirstStep;
-        size_t last = 0;
-        while(st + i < ed) {
-            if((st + i)->from < v) {
-                last = i;
-                i *= Multiplier;
-            } else {
-                break;
-            }
-        }
-        return LowerBound(st + last, std::min(st + i, ed), EdgeType(v, 0), CmpFrom<EdgeType>());
-    }
-
     // inline static size_t i_count[257] = {0};
     static const EdgeType* ExponentialSearchVertex2(VID v, const EdgeType* st, const EdgeType* ed) {
         if(st >= ed || st->from >= v) [[unlikely]] {
@@ -1248,7 +1728,7 @@ private:
             return st;
         }
 
-        size_t last = 4;
+        size_t last = Search::GallopScan;
         size_t len = ed - st;
         if(len <= last) [[unlikely]] {
             return LowerBound(st, ed, EdgeType(v, 0), CmpFrom<EdgeType>());
@@ -1260,7 +1740,7 @@ private:
             }
         }
         
-        constexpr size_t Multipliers = 8;
+        constexpr size_t Multipliers = Search::GallopMultiplier;
         size_t i = last * Multipliers;
         while(i < len && st[i].from < v) {
             // fmt::println("Exponential search: i={}, v={}, st[i]={}", i, v, st[i].from);
@@ -1365,7 +1845,7 @@ private:
     }
 
     /**
-     * @brief Internal only, build group index for a sorted range
+     * @brief Internal only, build group index for a sorted range, which is always the last sorted run
      */
     void BuildGroupIndex(EdgeType* begin, EdgeType* end) {
         auto index = GetRelatedIndexRange(begin, end);
@@ -1374,6 +1854,8 @@ private:
         size_t index_len = index.size();
         auto key = GetIndexKeyFunc(index_len);
         build_group_index(std::span<EdgeType>(begin, range_len), index, key);
+        BuildRunFence(begin, end);
+        BuildEdgeFilter(begin, end);
     }
 
     /**
@@ -1398,6 +1880,18 @@ private:
         return std::make_pair(nullptr, count);
     }
 
+    // Internal only, count new edges which are going to be sorted into sorted_degree_
+    void CountSortedDegree(const EdgeType* begin, const EdgeType* end) {
+        for(const EdgeType* it = begin; it != end; it++) {
+            sorted_degree_[it->from - vid_start_]++;
+        }
+        if(!touched_.empty()) {
+            for(const EdgeType* it = begin; it != end; it++) {
+                touched_.set(it->from - vid_start_);
+            }
+        }
+    }
+
     /**
      * @brief Internal only, sort multiple mini batches, a fast way to keep order
      */
@@ -1408,6 +1902,7 @@ private:
         auto [best_st, merged_ranges] = OptimizeMergeRangeStart(count * minimum_sort_batch_);
         size_t new_sorted_count = sorted_count_ + count * minimum_sort_batch_;
         EdgeType* ed = current_batch_ + new_sorted_count;
+        CountSortedDegree(current_batch_ + sorted_count_, ed);
         if(merged_ranges == 0) {
             // Only sort new mini batchs
             EdgeType* st = current_batch_ + sorted_count_;
@@ -1485,6 +1980,7 @@ private:
 
         // First level
         EdgeType* st = batch_end - len;
+        CountSortedDegree(st, batch_end);
         SmallRangeSort(st, batch_end);
         sort_times_[0]++;
         sorted_ranges_.append(new_sorted_count);
@@ -1568,7 +2064,7 @@ private:
 };
 
 
-template<typename Weight, typename VType=VID64, bool NeighborsOrder=false, bool StdSort=false, size_t MAX_MEM_PARTS_CNT=128, size_t MAX_PARTS_CNT=128>
+template<typename Weight, typename VType=VID64, bool NeighborsOrder=false, bool StdSort=false, size_t MAX_MEM_PARTS_CNT=128, size_t MAX_PARTS_CNT=128, SearchPolicy Search=DefaultSearchPolicy>
 class Graph {
 public:
     using WeightType = Weight;
@@ -1577,12 +2073,15 @@ public:
     using EdgeType = RawEdge<WeightType, VType>;
     using TargetType = CompactTarget<WeightType>;
     // using MemPartType = MemPartition<EdgeType>;
-    using MemPartType = SortBasedMemPartition<EdgeType, NeighborsOrder, StdSort>;
+    using MemPartType = SortBasedMemPartition<EdgeType, NeighborsOrder, StdSort, Search>;
     // using PartitionType = Partition<EdgeType>;
     using MutexType = SpinMutex;
 
     template<typename T, size_t N>
     using StaticVector = boost::container::static_vector<T, N>;
+
+    static constexpr size_t BATCH_PREFETCH_DISTANCE = 8;
+    static constexpr size_t DEFAULT_INTERLEAVE = 16;
 private:
     // Memory components
     // std::array<MemPartType, MAX_MEM_PARTS_CNT> mem_parts_;
@@ -1592,7 +2091,12 @@ private:
 
     size_t max_vertex_count_;       // 仅通过 AddMemPartition() 修改以上三个成员
     size_t vertex_count_;
-    size_t edge_count_;
+
+    // Edges ingested per writer thread id (one cache line each), summed by EdgeCount()
+    struct alignas(CACHE_LINE_SIZE) EdgeCounter {
+        size_t count = 0;
+    };
+    std::array<EdgeCounter, MemPartType::MAX_WRITE_THREADS> edge_counts_;
     const size_t part_width_;
     // const size_t bits_per_partition_;
     const size_t buffer_size_;
@@ -1634,7 +2138,7 @@ public:
     Graph(const fs::path& path, Config config, size_t graph_id=1)
         :   max_vertex_count_{0},
             vertex_count_{config.init_vertex_count},
-            edge_count_{0},
+            edge_counts_{},
             part_width_{config.partition_size},
             // part_width_{std::bit_ceil(config.partition_size)},
             // bits_per_partition_{std::bit_width(part_width_ - 1)},
@@ -1729,7 +2233,7 @@ public:
                 ExtendBlocks(need_parts);
             }
         }
-        // edge_count_ ++;
+        edge_counts_[thread_id].count++;
         // if(e.from < 50 && e.to < 50) {
         //     fmt::println("AddEdge: {} -> {}", e.from, e.to);
         // }
@@ -1740,12 +2244,33 @@ public:
         AddEdgeMultiThread(e, 0);
     }
 
-    void Collect() {
+    /**
+     * @brief Run func(part) on every memory partition concurrently, each in a thread running on the
+     * numa node of the partition. Only for maintenance work (collect, bitmap building, etc.).
+     */
+    template<typename Func>
+    void ForEachMemPartitionParallel(const Func& func) {
+        if(mem_parts_count() == 1) {
+            func(mem_parts_[0]);
+            return;
+        }
+        std::vector<std::jthread> threads;
+        threads.reserve(mem_parts_count());
         for(size_t i = 0; i < mem_parts_count(); i++) {
-            mem_parts_[i].Collect();
+            auto& part = mem_parts_[i];
+            threads.emplace_back([&part, &func](){
+                NumaRunOnNode(part.NumaNode());
+                func(part);
+            });
         }
     }
 
+    void Collect() {
+        ForEachMemPartitionParallel([](MemPartType& part) {
+            part.Collect();
+        });
+    }
+
     // Qurey API
 
     void WaitSortingAndPrepareAnalysisNoWait() {
@@ -1756,31 +2281,29 @@ public:
         for(size_t i = 0; i < mem_parts_count(); i++) {
             auto& part = mem_parts_[i];
             read_locks_.emplace_back(part.GetReadingMutex());
+            // The writer may not have run since last FinishAlgorithm (read_flag_ set again before it woke up),
+            // then edges made visible by Collect are not sorted yet, sort them here while holding its lock
+            while(!part.VisiblePartialSorted() && part.SortVisible()) {}
+            part.BuildTailIndex();
         }
     }
 
     void WaitSortingAndPrepareAnalysis() {
         read_flag_.test_and_set(std::memory_order_acquire);
-        for(size_t i = 0; i < mem_parts_count(); i++) {
-            auto& part = mem_parts_[i];
-            read_locks_.emplace_back(part.GetReadingMutex());
-        }
+        WaitToPrepared();
     }
 
     void BuildBitmapParallel() {
-        std::vector<std::thread> threads;
-        for(size_t i = 0; i < mem_parts_count(); i++) {
-            auto& part = mem_parts_[i];
-            threads.emplace_back([&part](){
-                part.BuildBitmap();
-            });
-        }
-        for(auto& t: threads) {
-            t.join();
-        }
+        ForEachMemPartitionParallel([](MemPartType& part) {
+            part.BuildBitmap();
+        });
     }
 
     void FinishAlgorithm() {
+        // Tail index must be invalidated before writers continue to append to the tail
+        for(size_t i = 0; i < mem_parts_count(); i++) {
+            mem_parts_[i].InvalidateTailIndex();
+        }
         read_flag_.clear(std::memory_order_seq_cst);
         read_flag_.notify_all();
         read_locks_.clear();
@@ -1801,8 +2324,17 @@ public:
         return vertex_count_;
     }
 
+    const Config& GetConfig() const {
+        return config_;
+    }
+
+    // Edges ingested so far, exact once writers stopped (e.g. after Collect)
     size_t EdgeCount() const {
-        return edge_count_;
+        size_t total = 0;
+        for(const auto& c: edge_counts_) {
+            total += c.count;
+        }
+        return total;
     }
 
     std::vector<EdgeType> GetNeighborsVectorInMemory(VID v) {
@@ -1825,6 +2357,82 @@ public:
         IterateNeighborsInMemory(v, func);
     }
 
+    /**
+     * @brief Iterate neighbors of a batch of vertices, func(from, to) may return bool (false to
+     * stop iterating current vertex). Lookups are software pipelined: index offsets of vertex i,
+     * first bucket probes of vertex i - D and the search and scan of vertex i - 2D are issued
+     * together, so cache misses of different vertices overlap.
+     */
+    template<typename Func>
+        requires std::invocable<Func, VID, VID>
+    void IterateNeighborsBatch(std::span<const VID> vertices, const Func& func) const {
+        constexpr size_t D = BATCH_PREFETCH_DISTANCE;
+        size_t n = vertices.size();
+        for(size_t i = 0; i < n + 2 * D; i++) {
+            if(i < n) {
+                VID v = vertices[i];
+                mem_parts_[GetPid(v)].PrefetchIndex(v);
+            }
+            if(i >= D && i - D < n) {
+                VID v = vertices[i - D];
+                mem_parts_[GetPid(v)].PrefetchBuckets(v);
+            }
+            if(i >= 2 * D && i - 2 * D < n) {
+                VID v = vertices[i - 2 * D];
+                mem_parts_[GetPid(v)].IterateNeighbors(v, [&](VID to) {
+                    return func(v, to);
+                });
+            }
+        }
+    }
+
+    template<typename RNG, typename Func>
+        requires std::invocable<Func, VID>
+    void SampleNeighborsUniform(VID v, size_t k, RNG& rng, const Func& func) const {
+        mem_parts_[GetPid(v)].SampleNeighborsUniform(v, k, rng, func);
+    }
+
+    /**
+     * @brief Draw k uniform neighbors (with replacement) for each vertex of a batch, func(from, to).
+     * Uses the same software pipeline as IterateNeighborsBatch. For mini-batch sampling of GNNs.
+     */
+    template<typename RNG, typename Func>
+        requires std::invocable<Func, VID, VID>
+    void SampleNeighborsUniformBatch(std::span<const VID> vertices, size_t k, RNG& rng, const Func& func) const {
+        constexpr size_t D = BATCH_PREFETCH_DISTANCE;
+        size_t n = vertices.size();
+        for(size_t i = 0; i < n + 2 * D; i++) {
+            if(i < n) {
+                VID v = vertices[i];
+                mem_parts_[GetPid(v)].PrefetchIndex(v);
+            }
+            if(i >= D && i - D < n) {
+                VID v = vertices[i - D];
+                mem_parts_[GetPid(v)].PrefetchBuckets(v);
+            }
+            if(i >= 2 * D && i - 2 * D < n) {
+                VID v = vertices[i - 2 * D];
+                mem_parts_[GetPid(v)].SampleNeighborsUniform(v, k, rng, [&](VID to) {
+                    func(v, to);
+                });
+            }
+        }
+    }
+
+    /**
+     * @brief Same as IterateNeighborsBatch, but every lookup is a coroutine and Interleave lookups
+     * are in flight on current thread (see coro.h). Fits irregular workloads where a fixed stage
+     * pipeline does not, e.g. vertices are produced while iterating (k-hop expansion).
+     */
+    template<size_t Interleave = DEFAULT_INTERLEAVE, typename Func>
+        requires std::invocable<Func, VID, VID>
+    void IterateNeighborsInterleaved(std::span<const VID> vertices, const Func& func) const {
+        RunInterleaved<Interleave>(vertices.size(), [&](size_t i) {
+            VID v = vertices[i];
+            return mem_parts_[GetPid(v)].IterateNeighborsCoro(v, &func);
+        });
+    }
+
     template<typename Func>
         requires std::invocable<Func, VID, VID>
     void IterateNeighborsRangeInLevel(VID v1, VID v2, size_t level, const Func& func) const {
@@ -1849,6 +2457,24 @@ public:
         }
     }
 
+    // func(std::span<const EdgeType>) gets contiguous blocks of edges of v
+    template<typename Func>
+        requires std::invocable<Func, std::span<const EdgeType>>
+    void IterateNeighborSpans(VID v, const Func& func) const {
+        mem_parts_[GetPid(v)].IterateNeighborSpans(v, func);
+    }
+
+    // func(std::span<const EdgeType>) gets contiguous blocks of edges whose source in [v1, v2)
+    template<typename Func>
+        requires std::invocable<Func, std::span<const EdgeType>>
+    void IterateNeighborSpansRange(VID v1, VID v2, const Func& func) const {
+        auto pid1 = GetPid(v1);
+        auto pid2 = GetPid(v2 - 1);
+        for(size_t pid = pid1; pid <= pid2; pid++) {
+            mem_parts_[pid].IterateNeighborSpansRange(v1, v2, func);
+        }
+    }
+
     template<typename Func>
         requires std::invocable<Func, VID, VID, size_t>
     void SampleNeighborsRangeInLevel(VID v1, VID v2, size_t sample_count, size_t level, const Func& func) const {
@@ -1932,6 +2558,39 @@ public:
         return GetDegreeInMemory(v);
     }
 
+    bool HasEdge(VID u, VID v) const {
+        return mem_parts_[GetPid(u)].HasEdge(u, v);
+    }
+
+    size_t MemPartitionCount() const {
+        return mem_parts_count();
+    }
+
+    // Sources of edges added since last ClearTouched (see SortBasedMemPartition::IterateTouchedVertices)
+    template<typename Func>
+        requires std::invocable<Func, VID>
+    void IterateTouchedVertices(const Func& func) const {
+        for(size_t i = 0; i < mem_parts_count(); i++) {
+            mem_parts_[i].IterateTouchedVertices(func);
+        }
+    }
+
+    // Call between WaitSortingAndPrepareAnalysis and FinishAlgorithm
+    void ClearTouched() {
+        for(size_t i = 0; i < mem_parts_count(); i++) {
+            mem_parts_[i].ClearTouched();
+        }
+    }
+
+    // Memory partition holding out edges of v, for grouping lookups by partition
+    size_t PartitionOf(VID v) const {
+        return GetPid(v);
+    }
+
+    int PartitionNumaNode(size_t pid) const {
+        return mem_parts_[pid].NumaNode();
+    }
+
 private:
     size_t GetPid(VID v) const {
         return v / part_width_;
@@ -2023,18 +2682,18 @@ private:
 
 };
 
-template<typename Weight, size_t MAX_MEM_PARTS_CNT=128, size_t MAX_PARTS_CNT=128>
-using Graph32 = Graph<Weight, VID32, false, false, MAX_MEM_PARTS_CNT, MAX_PARTS_CNT>;
+template<typename Weight, size_t MAX_MEM_PARTS_CNT=128, size_t MAX_PARTS_CNT=128, SearchPolicy Search=DefaultSearchPolicy>
+using Graph32 = Graph<Weight, VID32, false, false, MAX_MEM_PARTS_CNT, MAX_PARTS_CNT, Search>;
 
 
 
 // 这里要写一个UGraph，来载入无向图，并实现TC，要考虑自动配置。
-template<typename Weight, typename VType=VID64, bool NeighborsOrder=true, bool StdSort=false, size_t MAX_MEM_PARTS_CNT=128, size_t MAX_PARTS_CNT=128>
+template<typename Weight, typename VType=VID64, bool NeighborsOrder=true, bool StdSort=false, size_t MAX_MEM_PARTS_CNT=128, size_t MAX_PARTS_CNT=128, SearchPolicy Search=DefaultSearchPolicy>
 class UGraph {
 public:
     using VertexType = VType;
     using VID = VType;
-    using GraphType = Graph<Weight, VType, NeighborsOrder, StdSort, MAX_MEM_PARTS_CNT, MAX_PARTS_CNT>;
+    using GraphType = Graph<Weight, VType, NeighborsOrder, StdSort, MAX_MEM_PARTS_CNT, MAX_PARTS_CNT, Search>;
     using EdgeType = GraphType::EdgeType;
 private:
     GraphType g_;
@@ -2042,6 +2701,7 @@ private:
     size_t edge_count_;
     size_t new_edge_count_;
     const size_t dispatch_thread_count_;
+    std::shared_ptr<const VertexRelabeler<VID>> relabeler_;    // applied to every ingested edge if set
 
 public:
     UGraph(const fs::path& path, Config config)
@@ -2060,13 +2720,23 @@ public:
             int tid = omp_get_thread_num();
             #pragma omp for schedule(dynamic, 4096)
             for(size_t i = 0; i < sz; i++) {
-                auto e = edges[i];
+                auto e = relabeler_ ? relabeler_->Apply(edges[i]) : edges[i];
                 g_.AddEdgeMultiThread(e, tid);
                 g_.AddEdgeMultiThread(e.Reverse(), tid);
             }
         }
     }
 
+    // Relabel vertices of edges ingested from now on, see TGraph::SetRelabeler
+    void SetRelabeler(std::shared_ptr<const VertexRelabeler<VID>> relabeler) {
+        dcsr_assert(edge_count_ == 0, "Relabeler must be set before ingesting edges");
+        relabeler_ = std::move(relabeler);
+    }
+
+    const VertexRelabeler<VID>* Relabeler() const {
+        return relabeler_.get();
+    }
+
     void Collect() {
         g_.Collect();
     }
@@ -2084,21 +2754,84 @@ public:
         return g_;
     }
 
+    bool HasEdge(VID u, VID v) const {
+        return g_.HasEdge(u, v);
+    }
+
+    /**
+     * @brief Count common neighbors of u and v which are less than bound, by intersecting their
+     * neighbor blocks (sorted runs and tail) in place. Neighbors should have no duplicates.
+     * Every block of u is intersected with every block of v, R_u * R_v kernel calls scanning
+     * O(R_v * deg(u) + R_u * deg(v)) edges (less when galloping). Runs are merged geometrically
+     * (merge_multiplier), so R is small after compaction, but vertices with many unmerged runs pay
+     * the product.
+     */
+    size_t CountCommonNeighbors(VID u, VID v, VID bound = std::numeric_limits<VID>::max()) const {
+        static_assert(NeighborsOrder, "Intersection requires neighbors sorted by target");
+        auto blocks_u = NeighborBlocks(u, bound);
+        auto blocks_v = NeighborBlocks(v, bound);
+        size_t count = 0;
+        for(auto a: blocks_u) {
+            for(auto b: blocks_v) {
+                count += IntersectCount(a, b);
+            }
+        }
+        return count;
+    }
+
+    // Call func(w) for each common neighbor w of u and v, not in order
+    template<typename Func>
+        requires std::invocable<Func, VID>
+    void IntersectNeighbors(VID u, VID v, const Func& func) const {
+        static_assert(NeighborsOrder, "Intersection requires neighbors sorted by target");
+        auto blocks_u = NeighborBlocks(u, std::numeric_limits<VID>::max());
+        auto blocks_v = NeighborBlocks(v, std::numeric_limits<VID>::max());
+        for(auto a: blocks_u) {
+            for(auto b: blocks_v) {
+                IntersectBlocks(a, b, [&](const EdgeType* block, uint32_t mask) {
+                    for(; mask != 0; mask &= mask - 1) {
+                        func(block[std::countr_zero(mask)].to);
+                    }
+                });
+            }
+        }
+    }
+
+private:
+    using BlockList = boost::container::small_vector<std::span<const EdgeType>, 16>;
+
+    // Neighbor blocks of v, cut at the first target >= bound
+    BlockList NeighborBlocks(VID v, VID bound) const {
+        BlockList blocks;
+        g_.IterateNeighborSpans(v, [&](std::span<const EdgeType> s) {
+            if(s.back().to >= bound) {
+                auto it = std::lower_bound(s.begin(), s.end(), bound, [](const EdgeType& e, VID b) {
+                    return e.to < b;
+                });
+                s = s.first(it - s.begin());
+            }
+            if(!s.empty()) {
+                blocks.push_back(s);
+            }
+        });
+        return blocks;
+    }
+
 };
 
-template<typename Weight>
-using UGraph32 = UGraph<Weight, VID32, true, false>;
+template<typename Weight, SearchPolicy Search=DefaultSearchPolicy>
+using UGraph32 = UGraph<Weight, VID32, true, false, 128, 128, Search>;
 
 
 /**
  * @brief Two way graph, store edges in both directions
  */
-template<typename Weight, typename VType=VID64, bool NeighborsOrder=false, bool StdSort=false, size_t MAX_MEM_PARTS_CNT=128, size_t MAX_PARTS_CNT=128>
+template<typename Weight, typename VType=VID64, bool NeighborsOrder=false, bool StdSort=false, size_t MAX_MEM_PARTS_CNT=128, size_t MAX_PARTS_CNT=128, SearchPolicy Search=DefaultSearchPolicy>
 class TGraph {
 public:
     using VertexType = VType;
     using VID = VType;
-    using GraphType = Graph<Weight, VType, NeighborsOrder, StdSort, MAX_MEM_PARTS_CNT, MAX_PARTS_CNT>;
+    using GraphType = Graph<Weight, VType, NeighborsOrder, StdSort, MAX_MEM_PARTS_CNT, MAX_PARTS_CNT, Search>;
     using VersionType = std::pair<size_t, size_t>;
     using TargetType = GraphType::TargetType;
     using EdgeType = GraphType::EdgeType;
@@ -2108,9 +2841,14 @@ private:
     GraphType gout_;
 
 
-    size_t edge_count_;
     size_t new_edge_count_;
     const size_t dispatch_thread_count_;
+    std::unique_ptr<StreamingComponents<VID>> components_;     // nullptr unless config.stream_components
+    std::shared_ptr<const VertexRelabeler<VID>> relabeler_;    // applied to every ingested edge if set
+
+    EdgeType Relabel(EdgeType e) const {
+        return relabeler_ ? relabeler_->Apply(e) : e;
+    }
 
     // DispatchQueue qin_;
     // std::jthread din_;
@@ -2151,26 +2889,55 @@ public:
     TGraph(const fs::path& path, Config config)
         :   gin_(path / "in", config, 0),
             gout_(path / "out", config, 1),
-            edge_count_{0},
             new_edge_count_{0},
             dispatch_thread_count_{config.dispatch_thread_count}
     {
+        if(config.stream_components) {
+            dcsr_assert(!config.auto_extend, "Streaming components need a fixed vertex count (auto_extend = false)");
+            components_ = std::make_unique<StreamingComponents<VID>>(config.init_vertex_count);
+        }
 
         // din_ = std::jthread(Ingest<true>, std::ref(gin_), std::ref(qin_));
         // dout_ = std::jthread(Ingest<false>, std::ref(gout_), std::ref(qout_));
     }
 
+    /**
+     * @brief Relabel vertices of all edges ingested from now on (see VertexRelabeler), so the graph
+     * and analytics results use new IDs. Set it before the first edge.
+     */
+    void SetRelabeler(std::shared_ptr<const VertexRelabeler<VID>> relabeler) {
+        dcsr_assert(EdgeCount() == 0, "Relabeler must be set before ingesting edges");
+        relabeler_ = std::move(relabeler);
+    }
+
+    const VertexRelabeler<VID>* Relabeler() const {
+        return relabeler_.get();
+    }
+
     void AddEdge(EdgeType e) {
+        e = Relabel(e);
         gin_.AddEdge(e.Reverse());
         gout_.AddEdge(e);
+        if(components_) {
+            components_->Link(e.from, e.to);
+        }
     }
 
+    // AddEdgeIn and AddEdgeOut may each be the only path of an edge, so both link (twice is harmless)
     void AddEdgeIn(EdgeType e) {
+        e = Relabel(e);
         gin_.AddEdge(e.Reverse());
+        if(components_) {
+            components_->Link(e.from, e.to);
+        }
     }
 
     void AddEdgeOut(EdgeType e) {
+        e = Relabel(e);
         gout_.AddEdge(e);
+        if(components_) {
+            components_->Link(e.from, e.to);
+        }
     }
 
     // void AddEdgeBatch(std::span<const EdgeType> edges) {
@@ -2183,21 +2950,33 @@ public:
 
     void AddEdgeMultiThread(EdgeType e, size_t thread_id) {
         // fmt::println("Add({}): {}", thread_id, e);
+        e = Relabel(e);
         gin_.AddEdgeMultiThread(e.Reverse(), thread_id);
         gout_.AddEdgeMultiThread(e, thread_id);
+        if(components_) {
+            components_->Link(e.from, e.to);
+        }
     }
 
     void AddEdgeBatch(std::span<const EdgeType> edges) {
         size_t sz = edges.size();
-        edge_count_ += sz;
         new_edge_count_ += sz;
         #pragma omp parallel num_threads(dispatch_thread_count_)
         {
             int tid = omp_get_thread_num();
             #pragma omp for schedule(dynamic, 4096)
             for(size_t i = 0; i < sz; i++) {
-                gin_.AddEdgeMultiThread(edges[i].Reverse(), tid);
-                gout_.AddEdgeMultiThread(edges[i], tid);
+                auto e = Relabel(edges[i]);
+                gin_.AddEdgeMultiThread(e.Reverse(), tid);
+                gout_.AddEdgeMultiThread(e, tid);
+            }
+            // Union-find hook, edges of the batch are still in cache
+            if(components_) {
+                #pragma omp for schedule(dynamic, 4096) nowait
+                for(size_t i = 0; i < sz; i++) {
+                    auto e = Relabel(edges[i]);
+                    components_->Link(e.from, e.to);
+                }
             }
         }
         // if(new_edge_count_ > 64 * 1024 * 1024) {
@@ -2226,8 +3005,14 @@ public:
         return gin_.VertexCount();
     }
 
+    // gin_ and gout_ share one config
+    const Config& GetConfig() const {
+        return gout_.GetConfig();
+    }
+
+    // Counted by gin_ and gout_ on every ingest path, they differ only while AddEdgeIn / AddEdgeOut run
     size_t EdgeCount() const {
-        return gin_.EdgeCount();
+        return std::max(gin_.EdgeCount(), gout_.EdgeCount());
     }
 
     // Deprecated
@@ -2248,15 +3033,17 @@ public:
         return gin_.TotalSleepMillis() + gout_.TotalSleepMillis();
     }
 
+    // Collect gin_ and gout_ concurrently, they are independent
     void Collect() {
-        gin_.Collect();
+        std::jthread collect_in([this](){
+            gin_.Collect();
+        });
         gout_.Collect();
     }
 
     void WaitSortingAndPrepareAnalysis() {
         auto st = std::chrono::steady_clock::now();
-        gin_.Collect();
-        gout_.Collect();
+        Collect();
         auto et = std::chrono::steady_clock::now();
         fmt::println("Collect time: {:.2f}s", std::chrono::duration<double>(et - st).count());
         // din_.request_stop();
@@ -2300,6 +3087,35 @@ public:
         return gout_.GetDegreeInMemory(v);
     }
 
+    // Whether edge u->v exists, searched in out graph
+    bool HasEdge(VID u, VID v) const {
+        return gout_.HasEdge(u, v);
+    }
+
+    // Connected components maintained while ingesting, nullptr unless config.stream_components
+    StreamingComponents<VID>* MaintainedComponents() const {
+        return components_.get();
+    }
+
+    // Vertices with new out edges since last ClearTouched
+    template<typename Func>
+        requires std::invocable<Func, VID>
+    void IterateTouchedVerticesOut(const Func& func) const {
+        gout_.IterateTouchedVertices(func);
+    }
+
+    // Vertices with new in edges since last ClearTouched
+    template<typename Func>
+        requires std::invocable<Func, VID>
+    void IterateTouchedVerticesIn(const Func& func) const {
+        gin_.IterateTouchedVertices(func);
+    }
+
+    void ClearTouched() {
+        gin_.ClearTouched();
+        gout_.ClearTouched();
+    }
+
     template<typename Func>
         requires std::invocable<Func, VID>
     void IterateNeighborsIn(VID v, const Func& func) const {
@@ -2312,6 +3128,54 @@ public:
         gout_.IterateNeighborsInMemory(v, func);
     }
 
+    template<typename Func>
+        requires std::invocable<Func, VID, VID>
+    void IterateNeighborsInBatch(std::span<const VID> vertices, const Func& func) const {
+        gin_.IterateNeighborsBatch(vertices, func);
+    }
+
+    template<typename Func>
+        requires std::invocable<Func, VID, VID>
+    void IterateNeighborsOutBatch(std::span<const VID> vertices, const Func& func) const {
+        gout_.IterateNeighborsBatch(vertices, func);
+    }
+
+    template<typename Func>
+        requires std::invocable<Func, std::span<const EdgeType>>
+    void IterateNeighborSpansIn(VID v, const Func& func) const {
+        gin_.IterateNeighborSpans(v, func);
+    }
+
+    template<typename Func>
+        requires std::invocable<Func, std::span<const EdgeType>>
+    void IterateNeighborSpansOut(VID v, const Func& func) const {
+        gout_.IterateNeighborSpans(v, func);
+    }
+
+    template<typename Func>
+        requires std::invocable<Func, std::span<const EdgeType>>
+    void IterateNeighborSpansInRange(VID v1, VID v2, const Func& func) const {
+        gin_.IterateNeighborSpansRange(v1, v2, func);
+    }
+
+    template<typename Func>
+        requires std::invocable<Func, std::span<const EdgeType>>
+    void IterateNeighborSpansOutRange(VID v1, VID v2, const Func& func) const {
+        gout_.IterateNeighborSpansRange(v1, v2, func);
+    }
+
+    template<typename Func>
+        requires std::invocable<Func, VID, VID>
+    void IterateNeighborsInInterleaved(std::span<const VID> vertices, const Func& func) const {
+        gin_.IterateNeighborsInterleaved(vertices, func);
+    }
+
+    template<typename Func>
+        requires std::invocable<Func, VID, VID>
+    void IterateNeighborsOutInterleaved(std::span<const VID> vertices, const Func& func) const {
+        gout_.IterateNeighborsInterleaved(vertices, func);
+    }
+
     template<typename Func>
         requires std::invocable<Func, VID, VID>
     void IterateNeighborsInRangeInLevel(VID v1, VID v2, size_t level, const Func& func) const {
@@ -2366,16 +3230,61 @@ public:
         gout_.SampleNeighborsRange2(v1, v2, sample_count, func);
     }
 
+    template<typename RNG, typename Func>
+        requires std::invocable<Func, VID>
+    void SampleNeighborsInUniform(VID v, size_t k, RNG& rng, const Func& func) const {
+        gin_.SampleNeighborsUniform(v, k, rng, func);
+    }
+
+    template<typename RNG, typename Func>
+        requires std::invocable<Func, VID>
+    void SampleNeighborsOutUniform(VID v, size_t k, RNG& rng, const Func& func) const {
+        gout_.SampleNeighborsUniform(v, k, rng, func);
+    }
+
+    template<typename RNG, typename Func>
+        requires std::invocable<Func, VID, VID>
+    void SampleNeighborsInUniformBatch(std::span<const VID> vertices, size_t k, RNG& rng, const Func& func) const {
+        gin_.SampleNeighborsUniformBatch(vertices, k, rng, func);
+    }
+
+    template<typename RNG, typename Func>
+        requires std::invocable<Func, VID, VID>
+    void SampleNeighborsOutUniformBatch(std::span<const VID> vertices, size_t k, RNG& rng, const Func& func) const {
+        gout_.SampleNeighborsUniformBatch(vertices, k, rng, func);
+    }
+
+    // Random walks follow out edges (RandomWalkGraph), sampling and partitions are those of the out graph
+    template<typename RNG, typename Func>
+        requires std::invocable<Func, VID>
+    void SampleNeighborsUniform(VID v, size_t k, RNG& rng, const Func& func) const {
+        gout_.SampleNeighborsUniform(v, k, rng, func);
+    }
+
+    template<typename RNG, typename Func>
+        requires std::invocable<Func, VID, VID>
+    void SampleNeighborsUniformBatch(std::span<const VID> vertices, size_t k, RNG& rng, const Func& func) const {
+        gout_.SampleNeighborsUniformBatch(vertices, k, rng, func);
+    }
+
+    size_t MemPartitionCount() const {
+        return gout_.MemPartitionCount();
+    }
+
+    size_t PartitionOf(VID v) const {
+        return gout_.PartitionOf(v);
+    }
+
     void ValidateBitmapOut() {
         gout_.ValidateBitmap();
     }
 };
 
-template<typename Weight>
-using TGraph32 = TGraph<Weight, VID32, false, false, 128, 0>;
+template<typename Weight, SearchPolicy Search=DefaultSearchPolicy>
+using TGraph32 = TGraph<Weight, VID32, false, false, 128, 0, Search>;
 
-template<typename Weight>
-using TOGraph32 = TGraph<Weight, VID32, true, false, 128, 0>;
+template<typename Weight, SearchPolicy Search=DefaultSearchPolicy>
+using TOGraph32 = TGraph<Weight, VID32, true, false, 128, 0, Search>;
 
 }
 
@@ -0,0 +1,223 @@
+#ifndef __DCSR_INTERSECT_H__
+#define __DCSR_INTERSECT_H__
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace dcsr {
+
+/**
+ * @brief Intersection of neighbor blocks by target vertex, blocks are sorted by target and have
+ * no duplicated targets (e.g. blocks of IterateNeighborSpans with NeighborsOrder).
+ * Kernels report common targets by emit(const E* block, uint32_t mask): block[i] is common if
+ * bit i of mask is set.
+ */
+
+// Galloping is used when one block is GALLOP_RATIO times larger than the other
+static constexpr size_t GALLOP_RATIO = 32;
+
+enum class IntersectKernel {
+    Scalar,
+    Avx2,
+    Avx512,
+};
+
+// SIMD kernels load targets from 8 bytes edges with 32 bits target at offset 4 (RawEdge32<void>)
+template<typename E>
+concept SimdIntersectable = std::is_standard_layout_v<E> && sizeof(E) == 8
+                         && sizeof(E::to) == 4 && offsetof(E, to) == 4;
+
+IntersectKernel DetectIntersectKernel() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) {
+        return IntersectKernel::Avx512;
+    }
+    if(__builtin_cpu_supports("avx2")) {
+        return IntersectKernel::Avx2;
+    }
+#endif
+    return IntersectKernel::Scalar;
+}
+
+IntersectKernel ActiveIntersectKernel() {
+    static const IntersectKernel kernel = DetectIntersectKernel();
+    return kernel;
+}
+
+// Branchless merge
+template<typename E, typename Emit>
+void IntersectMerge(const E* a, const E* a_end, const E* b, const E* b_end, const Emit& emit) {
+    while(a != a_end && b != b_end) {
+        auto x = a->to;
+        auto y = b->to;
+        if(x == y) {
+            emit(a, 1u);
+        }
+        a += (x <= y);
+        b += (y <= x);
+    }
+}
+
+// First element in [first, last) whose target >= to, expected to be near first
+template<typename E, typename V>
+const E* GallopTarget(const E* first, const E* last, V to) {
+    size_t len = last - first;
+    size_t bound = 0;
+    size_t step = 1;
+    while(step < len && first[step].to < to) {
+        bound = step;
+        step *= 2;
+    }
+    const E* st = first + bound;
+    const E* ed = first + std::min(step + 1, len);
+    while(st < ed) {
+        const E* mid = st + (ed - st) / 2;
+        if(mid->to < to) {
+            st = mid + 1;
+        } else {
+            ed = mid;
+        }
+    }
+    return st;
+}
+
+// Each element of small block searches the large block from last position
+template<typename E, typename Emit>
+void IntersectGallop(const E* a, const E* a_end, const E* b, const E* b_end, const Emit& emit) {
+    for(; a != a_end && b != b_end; a++) {
+        b = GallopTarget(b, b_end, a->to);
+        if(b != b_end && b->to == a->to) {
+            emit(a, 1u);
+            b++;
+        }
+    }
+}
+
+#if defined(__x86_64__)
+// Targets of 8 edges: [f0 t0 f1 t1 ...] -> [t0 t1 ... t7]
+__attribute__((target("avx2")))
+static inline __m256i LoadTargetsAvx2(const void* edges) {
+    __m256 lo = _mm256_loadu_ps(static_cast<const float*>(edges));
+    __m256 hi = _mm256_loadu_ps(static_cast<const float*>(edges) + 8);
+    __m256i odd = _mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));   // t0 t1 t4 t5 | t2 t3 t6 t7
+    return _mm256_permute4x64_epi64(odd, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+// All pairs comparison of 8x8 blocks, advance the block with smaller max target
+template<typename E, typename Emit>
+__attribute__((target("avx2")))
+void IntersectAvx2(const E* a, const E* a_end, const E* b, const E* b_end, const Emit& emit) {
+    constexpr size_t W = 8;
+    const __m256i iota = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i lane_mask = _mm256_set1_epi32(W - 1);
+    while(a + W <= a_end && b + W <= b_end) {
+        __m256i va = LoadTargetsAvx2(a);
+        __m256i vb = LoadTargetsAvx2(b);
+        __m256i eq = _mm256_cmpeq_epi32(va, vb);
+        for(int k = 1; k < static_cast<int>(W); k++) {
+            __m256i rot = _mm256_and_si256(_mm256_add_epi32(iota, _mm256_set1_epi32(k)), lane_mask);
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, _mm256_permutevar8x32_epi32(vb, rot)));
+        }
+        uint32_t mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if(mask != 0) {
+            emit(a, mask);
+        }
+        auto a_max = a[W - 1].to;
+        auto b_max = b[W - 1].to;
+        a += (a_max <= b_max) * W;
+        b += (b_max <= a_max) * W;
+    }
+    IntersectMerge(a, a_end, b, b_end, emit);
+}
+
+// Targets of 16 edges
+__attribute__((target("avx512f")))
+static inline __m512i LoadTargetsAvx512(const void* edges) {
+    const __m512i odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    __m512i lo = _mm512_loadu_si512(edges);
+    __m512i hi = _mm512_loadu_si512(static_cast<const char*>(edges) + 64);
+    return _mm512_permutex2var_epi32(lo, odd, hi);
+}
+
+template<typename E, typename Emit>
+__attribute__((target("avx512f")))
+void IntersectAvx512(const E* a, const E* a_end, const E* b, const E* b_end, const Emit& emit) {
+    constexpr size_t W = 16;
+    const __m512i iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i lane_mask = _mm512_set1_epi32(W - 1);
+    while(a + W <= a_end && b + W <= b_end) {
+        __m512i va = LoadTargetsAvx512(a);
+        __m512i vb = LoadTargetsAvx512(b);
+        __mmask16 eq = _mm512_cmpeq_epi32_mask(va, vb);
+        for(int k = 1; k < static_cast<int>(W); k++) {
+            __m512i rot = _mm512_and_si512(_mm512_add_epi32(iota, _mm512_set1_epi32(k)), lane_mask);
+            eq |= _mm512_cmpeq_epi32_mask(va, _mm512_maskz_permutexvar_epi32(0xFFFF, rot, vb));
+        }
+        if(eq != 0) {
+            emit(a, static_cast<uint32_t>(eq));
+        }
+        auto a_max = a[W - 1].to;
+        auto b_max = b[W - 1].to;
+        a += (a_max <= b_max) * W;
+        b += (b_max <= a_max) * W;
+    }
+    IntersectMerge(a, a_end, b, b_end, emit);
+}
+#endif
+
+/**
+ * @brief Intersect two blocks, pick galloping for skewed sizes, otherwise the widest kernel
+ * supported by the CPU (scalar merge for other edge layouts).
+ */
+template<typename E, typename Emit>
+void IntersectBlocks(std::span<const E> a, std::span<const E> b, const Emit& emit) {
+    if(a.size() > b.size()) {
+        std::swap(a, b);
+    }
+    if(a.empty()) {
+        return;
+    }
+    const E* a_end = a.data() + a.size();
+    const E* b_end = b.data() + b.size();
+    if(a.size() * GALLOP_RATIO < b.size()) {
+        IntersectGallop(a.data(), a_end, b.data(), b_end, emit);
+        return;
+    }
+#if defined(__x86_64__)
+    if constexpr (SimdIntersectable<E>) {
+        switch(ActiveIntersectKernel()) {
+            case IntersectKernel::Avx512:
+                IntersectAvx512(a.data(), a_end, b.data(), b_end, emit);
+                return;
+            case IntersectKernel::Avx2:
+                IntersectAvx2(a.data(), a_end, b.data(), b_end, emit);
+                return;
+            default:
+                break;
+        }
+    }
+#endif
+    IntersectMerge(a.data(), a_end, b.data(), b_end, emit);
+}
+
+template<typename E>
+size_t IntersectCount(std::span<const E> a, std::span<const E> b) {
+    size_t count = 0;
+    IntersectBlocks(a, b, [&](const E*, uint32_t mask) {
+        count += std::popcount(mask);
+    });
+    return count;
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_INTERSECT_H__
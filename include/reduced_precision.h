@@ -0,0 +1,55 @@
+#ifndef __DCSR_REDUCED_PRECISION_H__
+#define __DCSR_REDUCED_PRECISION_H__
+
+#include <bit>
+#include <cstdint>
+
+namespace dcsr {
+
+// bfloat16: upper half of a float (8 bit exponent, 7 bit mantissa), rounded to nearest even.
+// Half the bytes of float for arrays read at random, arithmetic stays in float.
+struct BFloat16 {
+    uint16_t bits;
+
+    BFloat16() = default;
+
+    BFloat16(float f) {
+        uint32_t x = std::bit_cast<uint32_t>(f);
+        if((x & 0x7FFFFFFF) > 0x7F800000) {
+            bits = (x >> 16) | 0x40;    // quiet NaN
+        } else {
+            bits = (x + 0x7FFF + ((x >> 16) & 1)) >> 16;
+        }
+    }
+
+    operator float() const {
+        return std::bit_cast<float>(static_cast<uint32_t>(bits) << 16);
+    }
+};
+static_assert(sizeof(BFloat16) == 2);
+
+/**
+ * @brief 16 bit code of a degree: exact below 2^15, otherwise log scaled (5 bit shift, 11 bit
+ * mantissa with implicit leading one, truncated), relative error below 2^-10.
+ */
+inline uint16_t EncodeDegree16(uint32_t degree) {
+    if(degree < (1u << 15)) {
+        return degree;
+    }
+    uint32_t shift = std::bit_width(degree) - 11;
+    uint32_t mantissa = degree >> shift;
+    return 0x8000 | (shift << 10) | (mantissa & 0x3FF);
+}
+
+inline uint32_t DecodeDegree16(uint16_t code) {
+    if(code < 0x8000) {
+        return code;
+    }
+    uint32_t shift = (code >> 10) & 0x1F;
+    uint32_t mantissa = (code & 0x3FF) | 0x400;
+    return mantissa << shift;
+}
+
+} // namespace dcsr
+
+#endif // __DCSR_REDUCED_PRECISION_H__
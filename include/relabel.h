@@ -0,0 +1,246 @@
+#ifndef __DCSR_RELABEL_H__
+#define __DCSR_RELABEL_H__
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "common.h"
+
+namespace dcsr {
+
+enum class RelabelOrder {
+    Degree,     // decreasing degree, hubs share cache lines and pages
+    RCM,        // reverse Cuthill-McKee, BFS order with low degree first, small bandwidth
+    Gorder,     // greedy window order (Gorder without sibling score)
+};
+
+inline RelabelOrder ParseRelabelOrder(std::string_view name) {
+    if(name == "degree") {
+        return RelabelOrder::Degree;
+    } else if(name == "rcm") {
+        return RelabelOrder::RCM;
+    } else if(name == "gorder") {
+        return RelabelOrder::Gorder;
+    }
+    dcsr_assert(false, "Unknown relabel order (degree, rcm or gorder)");
+    return RelabelOrder::Degree;
+}
+
+/**
+ * @brief Permutation of vertex IDs applied to edges before they are dispatched, so vertices close
+ * in the new order are neighbors and analytics arrays indexed by vertex (levels, comp, scores) get
+ * better cache and TLB locality. It is computed once from a sample of the edges (or an initial bulk
+ * load), vertices missing from the sample keep their relative order after the sampled ones, and IDs
+ * >= VertexCount() are not changed. The inverse map translates results back to original IDs.
+ */
+template<typename VID>
+class VertexRelabeler {
+private:
+    std::vector<VID> new_id_;   // original -> new
+    std::vector<VID> old_id_;   // new -> original
+
+    // Undirected adjacency of the sample in CSR form
+    struct SampleGraph {
+        std::vector<size_t> offset;
+        std::vector<VID> adj;
+
+        size_t Degree(VID v) const {
+            return offset[v + 1] - offset[v];
+        }
+
+        std::span<const VID> Neighbors(VID v) const {
+            return std::span<const VID>(adj.data() + offset[v], adj.data() + offset[v + 1]);
+        }
+    };
+
+    template<typename E>
+    static SampleGraph BuildSampleGraph(std::span<const E> sample, size_t v_count) {
+        SampleGraph g;
+        g.offset.assign(v_count + 1, 0);
+        for(const auto& e: sample) {
+            if(e.from < v_count && e.to < v_count && e.from != e.to) {
+                g.offset[e.from + 1]++;
+                g.offset[e.to + 1]++;
+            }
+        }
+        std::partial_sum(g.offset.begin(), g.offset.end(), g.offset.begin());
+        g.adj.resize(g.offset[v_count]);
+        std::vector<size_t> cursor(g.offset.begin(), g.offset.end() - 1);
+        for(const auto& e: sample) {
+            if(e.from < v_count && e.to < v_count && e.from != e.to) {
+                g.adj[cursor[e.from]++] = e.to;
+                g.adj[cursor[e.to]++] = e.from;
+            }
+        }
+        return g;
+    }
+
+    // Vertices of the sample by decreasing degree, ties by ID
+    static std::vector<VID> DegreeOrder(const SampleGraph& g, size_t v_count) {
+        std::vector<VID> order;
+        for(size_t v = 0; v < v_count; v++) {
+            if(g.Degree(v) != 0) {
+                order.push_back(v);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [&](VID a, VID b) {
+            return g.Degree(a) > g.Degree(b);
+        });
+        return order;
+    }
+
+    static std::vector<VID> RCMOrder(const SampleGraph& g, size_t v_count) {
+        std::vector<VID> starts = DegreeOrder(g, v_count);
+        std::reverse(starts.begin(), starts.end());     // BFS roots of low degree first
+        std::vector<VID> order;
+        std::vector<uint8_t> visited(v_count);
+        std::vector<VID> next;
+        for(VID root: starts) {
+            if(visited[root]) {
+                continue;
+            }
+            visited[root] = 1;
+            size_t head = order.size();
+            order.push_back(root);
+            for(; head < order.size(); head++) {
+                next.clear();
+                for(VID u: g.Neighbors(order[head])) {
+                    if(!visited[u]) {
+                        visited[u] = 1;
+                        next.push_back(u);
+                    }
+                }
+                std::stable_sort(next.begin(), next.end(), [&](VID a, VID b) {
+                    return g.Degree(a) < g.Degree(b);
+                });
+                order.insert(order.end(), next.begin(), next.end());
+            }
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+    // Next vertex has most neighbors among the last window placed ones (lazy max heap)
+    static std::vector<VID> GorderOrder(const SampleGraph& g, size_t v_count, size_t window) {
+        std::vector<VID> seeds = DegreeOrder(g, v_count);
+        std::vector<VID> order;
+        order.reserve(seeds.size());
+        std::vector<uint32_t> key(v_count);
+        std::vector<uint8_t> placed(v_count);
+        std::priority_queue<std::pair<uint32_t, VID>> heap;
+        size_t seed = 0;
+        while(order.size() < seeds.size()) {
+            while(!heap.empty() && (placed[heap.top().second] || heap.top().first != key[heap.top().second])) {
+                heap.pop();
+            }
+            VID v;
+            if(!heap.empty()) {
+                v = heap.top().second;
+                heap.pop();
+            } else {
+                while(placed[seeds[seed]]) {
+                    seed++;
+                }
+                v = seeds[seed];
+            }
+            placed[v] = 1;
+            order.push_back(v);
+            for(VID u: g.Neighbors(v)) {
+                if(!placed[u]) {
+                    heap.emplace(++key[u], u);
+                }
+            }
+            if(order.size() > window) {
+                for(VID u: g.Neighbors(order[order.size() - window - 1])) {
+                    if(!placed[u]) {
+                        heap.emplace(--key[u], u);
+                    }
+                }
+            }
+        }
+        return order;
+    }
+
+public:
+    // order[new] = original, a permutation of [0, order.size())
+    explicit VertexRelabeler(std::vector<VID> order): new_id_(order.size()), old_id_(std::move(order)) {
+        std::vector<uint8_t> seen(old_id_.size());
+        for(size_t i = 0; i < old_id_.size(); i++) {
+            dcsr_assert(old_id_[i] < old_id_.size() && !seen[old_id_[i]], "Relabel order is not a permutation");
+            seen[old_id_[i]] = 1;
+            new_id_[old_id_[i]] = i;
+        }
+    }
+
+    template<typename E>
+    static VertexRelabeler FromSample(std::span<const E> sample, size_t v_count, RelabelOrder how, size_t window = 5) {
+        SampleGraph g = BuildSampleGraph(sample, v_count);
+        std::vector<VID> order;
+        switch(how) {
+        case RelabelOrder::Degree:
+            order = DegreeOrder(g, v_count);
+            break;
+        case RelabelOrder::RCM:
+            order = RCMOrder(g, v_count);
+            break;
+        case RelabelOrder::Gorder:
+            order = GorderOrder(g, v_count, window);
+            break;
+        }
+        for(size_t v = 0; v < v_count; v++) {
+            if(g.Degree(v) == 0) {
+                order.push_back(v);
+            }
+        }
+        return VertexRelabeler(std::move(order));
+    }
+
+    size_t VertexCount() const {
+        return new_id_.size();
+    }
+
+    VID ToNew(VID v) const {
+        return v < new_id_.size() ? new_id_[v] : v;
+    }
+
+    VID ToOriginal(VID v) const {
+        return v < old_id_.size() ? old_id_[v] : v;
+    }
+
+    template<typename E>
+    E Apply(E e) const {
+        e.from = ToNew(e.from);
+        e.to = ToNew(e.to);
+        return e;
+    }
+
+    // values indexed by new ID (scores, levels) -> indexed by original ID
+    template<typename T>
+    std::unique_ptr<T[]> ToOriginalOrder(const T* values, size_t n) const {
+        auto result = std::make_unique_for_overwrite<T[]>(n);
+        #pragma omp parallel for schedule(static)
+        for(size_t v = 0; v < n; v++) {
+            result[v] = values[ToNew(v)];
+        }
+        return result;
+    }
+
+    // Same for arrays of vertex IDs (parents, component labels), values are translated too
+    std::unique_ptr<VID[]> ToOriginalVertices(const VID* values, size_t n) const {
+        auto result = std::make_unique_for_overwrite<VID[]>(n);
+        #pragma omp parallel for schedule(static)
+        for(size_t v = 0; v < n; v++) {
+            result[v] = ToOriginal(values[ToNew(v)]);
+        }
+        return result;
+    }
+};
+
+} // namespace dcsr
+
+#endif // __DCSR_RELABEL_H__
@@ -3,6 +3,7 @@
 
 #include <cassert>
 #include <csignal>
+#include <cstring>
 #include <memory>
 #include <span>
 #include <queue>
@@ -720,8 +721,14 @@ public:
         }
     }
 
+    /**
+     * @brief Gather partial sub buffers into one contiguous region, so that only one partial block
+     * (sub_buffers_[0]) remains at the end of the visible data. Order inside partial blocks is
+     * irrelevant (unsorted data), so edges are moved with bulk copies from the tail blocks.
+     * No heap allocation: at most MAX_THREADS partial blocks exist.
+     */
     void Collect() {
-        std::vector<std::pair<T*, size_t>> not_full;
+        boost::container::static_vector<std::pair<T*, size_t>, MAX_THREADS> not_full;
         for(size_t i = 0; i < write_threads_; i++) {
             // fmt::println("Not full: {} ({})", sub_buffers_[i].buffer - buffer_, sub_buffers_[i].size);
             not_full.push_back({sub_buffers_[i].buffer, sub_buffers_[i].size});
@@ -738,10 +745,9 @@ public:
         while(need_to_fill_buf < need_to_move_buf) {
             if(mpos <= visible_batch_size_ - pos) {  // move all
                 // fmt::println("A: Move {} from {} to {}", mpos, need_to_move_buf - buffer_, need_to_fill_buf - buffer_);
-                while(mpos > 0) {
-                    need_to_fill_buf[pos ++] = need_to_move_buf[mpos - 1];
-                    mpos --;
-                }
+                std::memcpy(need_to_fill_buf + pos, need_to_move_buf, mpos * sizeof(T));
+                pos += mpos;
+                mpos = 0;
 
                 need_to_move_buf -= visible_batch_size_;
                 if(need_to_move_buf == need_to_fill_buf) {
@@ -758,11 +764,10 @@ public:
 
             } else {
                 // fmt::println("B: Move {} from {} to {}", visible_batch_size_ - pos, need_to_move_buf - buffer_, need_to_fill_buf - buffer_);
-                while(pos < visible_batch_size_) {
-                    need_to_fill_buf[pos] = need_to_move_buf[mpos - 1];
-                    pos ++;
-                    mpos --;
-                }
+                size_t cnt = visible_batch_size_ - pos;
+                std::memcpy(need_to_fill_buf + pos, need_to_move_buf + mpos - cnt, cnt * sizeof(T));
+                pos += cnt;
+                mpos -= cnt;
                 // fmt::println("After move: pos={}, mpos={}", pos, mpos);
                 if(k == write_threads_ - 1) {
                     break;
@@ -808,6 +813,11 @@ public:
         return latest;
     }
 
+    // Max size of ReadyData()
+    size_t ReadyDataCapacity() const {
+        return visible_batch_size_;
+    }
+
     const_array_range ReadyData() const {
         auto& sb0 = sub_buffers_[0];
         return const_array_range(sb0.buffer, sb0.size);
@@ -0,0 +1,93 @@
+#ifndef __DCSR_SEARCH_POLICY_H__
+#define __DCSR_SEARCH_POLICY_H__
+
+#include <algorithm>
+#include <concepts>
+#include "third_party/sb_lower_bound.h"
+
+namespace dcsr {
+
+/**
+ * @brief Search policies used by SortBasedMemPartition to locate a vertex inside a bucket of a
+ * sorted run. A policy provides LowerBound(first, last, value, comp) and the parameters of the
+ * exponential (galloping) search used when skipping to a following vertex:
+ *   first GallopScan elements are scanned linearly, then the step grows by GallopMultiplier.
+ * Use app/tuning/search_policy to pick the best one for a machine.
+ */
+struct SearchPolicyBase {
+    static constexpr size_t GallopScan = 4;
+    static constexpr size_t GallopMultiplier = 8;
+};
+
+struct StdSearch: SearchPolicyBase {
+    static constexpr const char* name = "std";
+
+    template <class ForwardIt, class T, class Compare>
+    static constexpr ForwardIt LowerBound(ForwardIt first, ForwardIt last, const T& value, const Compare& comp) {
+        return std::lower_bound(first, last, value, comp);
+    }
+};
+
+// Shar's algorithm, branchy
+struct SbSearch: SearchPolicyBase {
+    static constexpr const char* name = "sb";
+
+    template <class ForwardIt, class T, class Compare>
+    static constexpr ForwardIt LowerBound(ForwardIt first, ForwardIt last, const T& value, const Compare& comp) {
+        return sb_lower_bound(first, last, value, comp);
+    }
+};
+
+// Shar's algorithm, cmov by multiply
+struct SbmSearch: SearchPolicyBase {
+    static constexpr const char* name = "sbm";
+
+    template <class ForwardIt, class T, class Compare>
+    static constexpr ForwardIt LowerBound(ForwardIt first, ForwardIt last, const T& value, const Compare& comp) {
+        return sbm_lower_bound(first, last, value, comp);
+    }
+};
+
+// Shar's algorithm, cmov by multiply, prefetch both halves for large ranges
+struct SbpmSearch: SearchPolicyBase {
+    static constexpr const char* name = "sbpm";
+
+    template <class ForwardIt, class T, class Compare>
+    static constexpr ForwardIt LowerBound(ForwardIt first, ForwardIt last, const T& value, const Compare& comp) {
+        return sbpm_lower_bound(first, last, value, comp);
+    }
+};
+
+struct BranchlessSearch: SearchPolicyBase {
+    static constexpr const char* name = "branchless";
+
+    template <class ForwardIt, class T, class Compare>
+    static ForwardIt LowerBound(ForwardIt first, ForwardIt last, const T& value, const Compare& comp) {
+        return branchless_lower_bound(first, last, value, comp);
+    }
+};
+
+#if defined(__x86_64__)
+// Explicit cmova, x86 only
+struct AsmSearch: SearchPolicyBase {
+    static constexpr const char* name = "asm";
+
+    template <class ForwardIt, class T, class Compare>
+    static constexpr ForwardIt LowerBound(ForwardIt first, ForwardIt last, const T& value, const Compare& comp) {
+        return asm_lower_bound(first, last, value, comp);
+    }
+};
+#endif
+
+using DefaultSearchPolicy = StdSearch;
+
+template<typename P>
+concept SearchPolicy = requires {
+    { P::name } -> std::convertible_to<const char*>;
+    { P::GallopScan } -> std::convertible_to<size_t>;
+    { P::GallopMultiplier } -> std::convertible_to<size_t>;
+} && P::GallopScan >= 1 && P::GallopMultiplier >= 2;
+
+} // namespace dcsr
+
+#endif // __DCSR_SEARCH_POLICY_H__
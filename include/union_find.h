@@ -0,0 +1,86 @@
+#ifndef __DCSR_UNION_FIND_H__
+#define __DCSR_UNION_FIND_H__
+
+#include <span>
+#include "env/memory.h"
+
+namespace dcsr {
+
+template<typename T>
+bool compare_and_swap(T &x, const T &old_val, const T &new_val) {
+    return __sync_bool_compare_and_swap(&x, old_val, new_val);
+}
+
+// Place nodes u and v in same component of lower component ID
+template<typename NodeID>
+void Link(NodeID u, NodeID v, NodeID* comp) {
+    NodeID p1 = comp[u];
+    NodeID p2 = comp[v];
+    while (p1 != p2) {
+        NodeID high = p1 > p2 ? p1 : p2;
+        NodeID low = p1 + (p2 - high);
+        NodeID p_high = comp[high];
+        // Was already 'low' or succeeded in writing 'low'
+        if ((p_high == low) || (p_high == high && compare_and_swap(comp[high], high, low)))
+            break;
+        p1 = comp[comp[high]]; // Union-Find ? path compression?
+        p2 = comp[low];
+    }
+}
+
+// Reduce depth of tree for each component to 1 by crawling up parents
+template<typename NodeID>
+void Compress(std::span<NodeID> comp) {
+  #pragma omp parallel for schedule(dynamic, 16384)
+  for (NodeID n = 0; n < comp.size(); n++) {
+    while (comp[n] != comp[comp[n]]) {
+      comp[n] = comp[comp[n]];
+    }
+  }
+}
+
+/**
+ * @brief Connected components maintained online by lock-free Link of every ingested edge
+ * (insert-only streams). comp is interleaved over NUMA nodes, as ingesting threads of all nodes
+ * link random vertices. Labels() compresses the trees, then comp[v] is the smallest vertex
+ * of the component of v. Link may run concurrently, but not with Labels().
+ */
+template<typename NodeID>
+class StreamingComponents {
+private:
+    size_t v_count_;
+    NodeID* comp_;
+
+public:
+    explicit StreamingComponents(size_t v_count)
+    : v_count_(v_count), comp_(NumaAllocArrayInterleaved<NodeID>(v_count)) {
+        #pragma omp parallel for schedule(static, 16384)
+        for (size_t v = 0; v < v_count_; v++) {
+            comp_[v] = v;
+        }
+    }
+
+    StreamingComponents(const StreamingComponents&) = delete;
+    StreamingComponents& operator=(const StreamingComponents&) = delete;
+
+    ~StreamingComponents() {
+        NumaFreeArray(comp_, v_count_);
+    }
+
+    void Link(NodeID u, NodeID v) {
+        dcsr::Link(u, v, comp_);
+    }
+
+    size_t VertexCount() const {
+        return v_count_;
+    }
+
+    std::span<const NodeID> Labels() {
+        Compress(std::span<NodeID>(comp_, v_count_));
+        return std::span<const NodeID>(comp_, v_count_);
+    }
+};
+
+} // namespace dcsr
+
+#endif // __DCSR_UNION_FIND_H__